@@ -0,0 +1,10 @@
+TEMPLATE = subdirs
+# The benchmarks are not built by default, run qmake with
+# "CONFIG+=framelesshelper_build_benchmarks" to enable them.
+framelesshelper_build_benchmarks {
+    SUBDIRS += core sysapiloader
+    qtHaveModule(widgets): SUBDIRS += widgets interaction
+    unix:!macx:qtHaveModule(dbus): SUBDIRS += xdgportal
+} else {
+    message("The FramelessHelper benchmarks are disabled, pass CONFIG+=framelesshelper_build_benchmarks to qmake to build them.")
+}
@@ -0,0 +1,9 @@
+TEMPLATE = app
+TARGET = tst_bench_core
+QT += testlib
+CONFIG += testcase
+HEADERS += \
+    ../shared/benchmark.h
+SOURCES += \
+    tst_bench_core.cpp
+include(../../qmake/core.pri)
@@ -0,0 +1,220 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <QtTest/qtest.h>
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qbrush.h>
+#include <FramelessHelper/Core/framelessmanager.h>
+#include <FramelessHelper/Core/private/sysapiloader_p.h>
+#if FRAMELESSHELPER_CONFIG(titlebar)
+#  include <FramelessHelper/Core/chromepalette.h>
+#endif
+#if FRAMELESSHELPER_CONFIG(mica_material)
+#  include <FramelessHelper/Core/private/micamaterial_p.h>
+#endif
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "../shared/benchmark.h"
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+using namespace Global;
+
+[[nodiscard]] static inline QImage createWallpaper(const QSize &size)
+{
+    // Something with a bit of detail, a plain color would be too friendly to the caches.
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    QLinearGradient gradient(QPointF(0, 0), QPointF(size.width(), size.height()));
+    gradient.setColorAt(0.0, QColor(32, 96, 160));
+    gradient.setColorAt(0.5, QColor(240, 200, 80));
+    gradient.setColorAt(1.0, QColor(120, 20, 60));
+    painter.fillRect(image.rect(), gradient);
+    painter.setPen(QColor(255, 255, 255, 96));
+    for (int x = 0; x < size.width(); x += 37) {
+        painter.drawLine(x, 0, (size.width() - x), size.height());
+    }
+    painter.end();
+    return image;
+}
+
+class tst_BenchCore : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void halfScaled_data();
+    void halfScaled();
+    void blurImage_data();
+    void blurImage();
+    void sysApiLoaderGet_data();
+    void sysApiLoaderGet();
+    void chromePaletteRefresh_data();
+    void chromePaletteRefresh();
+};
+
+static inline void addResolutionRows()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::newRow("1080p") << QSize(1920, 1080);
+    QTest::newRow("1440p") << QSize(2560, 1440);
+    QTest::newRow("4K") << QSize(3840, 2160);
+}
+
+void tst_BenchCore::halfScaled_data()
+{
+    addResolutionRows();
+}
+
+void tst_BenchCore::halfScaled()
+{
+#if (FRAMELESSHELPER_CONFIG(mica_material) && FRAMELESSHELPER_CONFIG(private_qt))
+    QFETCH(QSize, size);
+    const QImage source = createWallpaper(size);
+    // The library may have been built without the kernels, in which case the image is
+    // returned as is and we would be timing an empty function.
+    if (MicaMaterialPrivate::halfScaled(source).size() == source.size()) {
+        QSKIP("The library was built without the blur kernels.");
+    }
+    QImage result = {};
+    QBENCHMARK {
+        result = MicaMaterialPrivate::halfScaled(source);
+    }
+    QCOMPARE(result.size(), (size / 2));
+#else
+    QSKIP("The blur kernels are not available in this configuration.");
+#endif
+}
+
+void tst_BenchCore::blurImage_data()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<qreal>("radius");
+    for (auto &&radius : { qreal(32), qreal(128) }) {
+        const QByteArray suffix = " r" + QByteArray::number(radius);
+        QTest::newRow(("1080p" + suffix).constData()) << QSize(1920, 1080) << radius;
+        QTest::newRow(("1440p" + suffix).constData()) << QSize(2560, 1440) << radius;
+        QTest::newRow(("4K" + suffix).constData()) << QSize(3840, 2160) << radius;
+    }
+}
+
+void tst_BenchCore::blurImage()
+{
+#if (FRAMELESSHELPER_CONFIG(mica_material) && FRAMELESSHELPER_CONFIG(private_qt))
+    QFETCH(QSize, size);
+    QFETCH(qreal, radius);
+    const QImage source = createWallpaper(size);
+    QImage probe = source;
+    MicaMaterialPrivate::blurImage(probe, radius);
+    if (probe == source) {
+        QSKIP("The library was built without the blur kernels.");
+    }
+    QBENCHMARK {
+        // The blur works on a (half scaled) copy, the source is never detached.
+        QImage image = source;
+        MicaMaterialPrivate::blurImage(image, radius);
+    }
+#else
+    QSKIP("The blur kernels are not available in this configuration.");
+#endif
+}
+
+void tst_BenchCore::sysApiLoaderGet_data()
+{
+    QTest::addColumn<bool>("staticSlot");
+    QTest::newRow("cached lookup") << false;
+    QTest::newRow("static slot") << true;
+}
+
+void tst_BenchCore::sysApiLoaderGet()
+{
+    QFETCH(bool, staticSlot);
+    const QString library = Benchmark::systemLibrary();
+    const QString function = Benchmark::systemFunctions().constFirst();
+    SysApiLoader * const loader = SysApiLoader::instance();
+    if (!loader->isAvailable(library, function)) {
+        QSKIP("The test symbol can't be resolved on this system.");
+    }
+    QFunctionPointer symbol = nullptr;
+    if (staticSlot) {
+        QBENCHMARK {
+            symbol = API_SYMBOL(benchmark, function, QFunctionPointer)::get(library, function);
+        }
+    } else {
+        QBENCHMARK {
+            symbol = loader->get(library, function);
+        }
+    }
+    QVERIFY(symbol);
+}
+
+void tst_BenchCore::chromePaletteRefresh_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("1 window") << 1;
+    QTest::newRow("10 windows") << 10;
+    QTest::newRow("100 windows") << 100;
+    QTest::newRow("1000 windows") << 1000;
+}
+
+void tst_BenchCore::chromePaletteRefresh()
+{
+#if FRAMELESSHELPER_CONFIG(titlebar)
+    QFETCH(int, count);
+    std::vector<std::unique_ptr<ChromePalette>> palettes = {};
+    palettes.reserve(count);
+    for (int i = 0; i != count; ++i) {
+        auto palette = std::make_unique<ChromePalette>();
+        // Palettes nobody has read from yet skip the refresh entirely, read them
+        // once like a title bar painting itself would.
+        std::ignore = palette->titleBarActiveBackgroundColor();
+        palettes.push_back(std::move(palette));
+    }
+    FramelessManager * const manager = FramelessManager::instance();
+    bool dark = (manager->systemTheme() != SystemTheme::Dark);
+    // Each iteration is a real theme switch, so every palette has to re-read the
+    // shared color table and notify the colors that have changed.
+    QBENCHMARK {
+        manager->setOverrideTheme(dark ? SystemTheme::Dark : SystemTheme::Light);
+        dark = !dark;
+    }
+    manager->setOverrideTheme(SystemTheme::Unknown);
+#else
+    QSKIP("The ChromePalette class is not available in this configuration.");
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    Benchmark::initialize(FramelessHelperCoreInitialize);
+    QGuiApplication application(argc, argv);
+    tst_BenchCore test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_bench_core.moc"
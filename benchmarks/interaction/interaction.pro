@@ -0,0 +1,17 @@
+TEMPLATE = app
+TARGET = tst_interaction
+QT += testlib widgets
+CONFIG += testcase
+HEADERS += \
+    ../shared/benchmark.h
+SOURCES += \
+    tst_interaction.cpp
+unix:!macx:packagesExist(xcb) {
+    # The _NET_WM_MOVERESIZE sink opens its own X connection.
+    CONFIG += link_pkgconfig
+    PKGCONFIG += xcb
+    DEFINES += FRAMELESSHELPER_BENCHMARKS_HAS_XCB
+}
+include(../../qmake/core.pri)
+include(../../qmake/widgets.pri)
+qtHaveModule(quick): include(../../qmake/quick.pri)
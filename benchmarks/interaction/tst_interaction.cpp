@@ -0,0 +1,741 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtGui/qevent.h>
+#include <QtGui/qwindow.h>
+#include <QtWidgets/qapplication.h>
+#include <QtWidgets/qboxlayout.h>
+#include <FramelessHelper/Core/framelessmanager.h>
+#include <FramelessHelper/Core/utils.h>
+#include <FramelessHelper/Widgets/framelesswidgetshelper.h>
+#include <FramelessHelper/Widgets/framelesswidget.h>
+#include <FramelessHelper/Widgets/framelessmainwindow.h>
+#include <FramelessHelper/Widgets/standardtitlebar.h>
+#if FRAMELESSHELPER_CONFIG(quick)
+#  include <QtQml/qqmlapplicationengine.h>
+#  include <QtQuick/qquickwindow.h>
+#  include <FramelessHelper/Quick/framelessquickmodule.h>
+#  include <FramelessHelper/Quick/framelessquickhelper.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include "../shared/benchmark.h"
+
+// The move resize sink talks to the X server through its own connection, which needs
+// the real libxcb and not just the subset FramelessHelper resolves at runtime.
+#if (defined(Q_OS_LINUX) && defined(FRAMELESSHELPER_HAS_XCB) && defined(FRAMELESSHELPER_BENCHMARKS_HAS_XCB))
+#  define FRAMELESSHELPER_BENCHMARKS_MOVERESIZE_SINK
+#endif
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+using namespace Global;
+
+static constexpr const QSize kWindowSize = { 800, 600 };
+static constexpr const int kIterations = 50;
+static constexpr const int kHoverStep = 8;
+static constexpr const int kMessageTimeout = 1000; // Milliseconds.
+
+enum class WindowKind : int
+{
+    Widget,
+    MainWindow,
+    QuickWindow
+};
+Q_DECLARE_METATYPE(WindowKind)
+
+#ifdef FRAMELESSHELPER_BENCHMARKS_MOVERESIZE_SINK
+// Without a window manager nobody advertises or consumes _NET_WM_MOVERESIZE, so both Qt's
+// XCB plugin and Utils::sendMoveResizeMessage() would silently drop the request. The sink
+// pretends to be that window manager: it adds the atom to the root window's _NET_SUPPORTED
+// (it must do so before the QApplication connects, both sides cache the list) and then
+// watches the root window for the client messages the library sends.
+class MoveResizeSink
+{
+    Q_DISABLE_COPY_MOVE(MoveResizeSink)
+
+public:
+    struct Message
+    {
+        xcb_window_t window = XCB_NONE;
+        QPoint globalPos = {};
+        quint32 action = 0;
+        quint32 button = 0;
+        qint64 timestamp = 0; // Nanoseconds, see clock().
+    };
+
+    explicit MoveResizeSink();
+    ~MoveResizeSink();
+
+    [[nodiscard]] static MoveResizeSink *instance();
+    static void setInstance(MoveResizeSink *sink);
+
+    [[nodiscard]] bool isActive() const;
+    [[nodiscard]] bool isMocked() const;
+    [[nodiscard]] const QElapsedTimer &clock() const;
+
+    void clear();
+    [[nodiscard]] std::optional<Message> takeMessage(const WId windowId, const int timeout);
+
+private:
+    void collect();
+
+private:
+    static inline MoveResizeSink *m_instance = nullptr;
+    xcb_connection_t *m_connection = nullptr;
+    xcb_window_t m_rootWindow = XCB_NONE;
+    xcb_atom_t m_moveResizeAtom = XCB_NONE;
+    xcb_atom_t m_netSupportedAtom = XCB_NONE;
+    bool m_mocked = false;
+    QElapsedTimer m_clock = {};
+    QList<Message> m_messages = {};
+};
+
+[[nodiscard]] static inline xcb_atom_t sinkInternAtom(xcb_connection_t *connection, const char *name)
+{
+    const xcb_intern_atom_cookie_t cookie = xcb_intern_atom(connection, false, qstrlen(name), name);
+    xcb_intern_atom_reply_t * const reply = xcb_intern_atom_reply(connection, cookie, nullptr);
+    if (!reply) {
+        return XCB_NONE;
+    }
+    const xcb_atom_t atom = reply->atom;
+    std::free(reply);
+    return atom;
+}
+
+MoveResizeSink::MoveResizeSink()
+{
+    m_clock.start();
+    int screenNumber = 0;
+    m_connection = xcb_connect(nullptr, &screenNumber);
+    if (!m_connection || xcb_connection_has_error(m_connection)) {
+        qWarning() << "MoveResizeSink: Failed to connect to the X server.";
+        return;
+    }
+    xcb_screen_iterator_t it = xcb_setup_roots_iterator(xcb_get_setup(m_connection));
+    for (int i = 0; (i != screenNumber) && it.rem; ++i) {
+        xcb_screen_next(&it);
+    }
+    if (!it.rem) {
+        return;
+    }
+    m_rootWindow = it.data->root;
+    m_moveResizeAtom = sinkInternAtom(m_connection, ATOM_NET_WM_MOVERESIZE);
+    m_netSupportedAtom = sinkInternAtom(m_connection, ATOM_NET_SUPPORTED);
+    const xcb_atom_t wmCheckAtom = sinkInternAtom(m_connection, "_NET_SUPPORTING_WM_CHECK");
+    if ((m_moveResizeAtom == XCB_NONE) || (m_netSupportedAtom == XCB_NONE) || (wmCheckAtom == XCB_NONE)) {
+        qWarning() << "MoveResizeSink: Failed to retrieve the EWMH atoms.";
+        return;
+    }
+    // Only stand in for the window manager when there isn't one, a real one keeps handling
+    // the requests and we merely observe them.
+    const xcb_get_property_cookie_t cookie = xcb_get_property(m_connection, false, m_rootWindow, wmCheckAtom, XCB_ATOM_WINDOW, 0, 1);
+    if (xcb_get_property_reply_t * const reply = xcb_get_property_reply(m_connection, cookie, nullptr)) {
+        m_mocked = (xcb_get_property_value_length(reply) <= 0);
+        std::free(reply);
+    }
+    if (m_mocked) {
+        xcb_change_property(m_connection, XCB_PROP_MODE_APPEND, m_rootWindow, m_netSupportedAtom, XCB_ATOM_ATOM, 32, 1, &m_moveResizeAtom);
+    }
+    // SubstructureNotify is enough to see the messages, redirecting would make us a real window manager.
+    const quint32 eventMask = XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY;
+    xcb_change_window_attributes(m_connection, m_rootWindow, XCB_CW_EVENT_MASK, &eventMask);
+    xcb_flush(m_connection);
+}
+
+MoveResizeSink::~MoveResizeSink()
+{
+    if (!m_connection) {
+        return;
+    }
+    if (m_mocked) {
+        // We were the only one filling it in, don't leave a lie behind for the next test.
+        xcb_delete_property(m_connection, m_rootWindow, m_netSupportedAtom);
+    }
+    xcb_disconnect(m_connection);
+}
+
+MoveResizeSink *MoveResizeSink::instance()
+{
+    return m_instance;
+}
+
+void MoveResizeSink::setInstance(MoveResizeSink *sink)
+{
+    m_instance = sink;
+}
+
+bool MoveResizeSink::isActive() const
+{
+    return (m_connection && (m_rootWindow != XCB_NONE) && (m_moveResizeAtom != XCB_NONE));
+}
+
+bool MoveResizeSink::isMocked() const
+{
+    return m_mocked;
+}
+
+const QElapsedTimer &MoveResizeSink::clock() const
+{
+    return m_clock;
+}
+
+void MoveResizeSink::clear()
+{
+    collect();
+    m_messages.clear();
+}
+
+void MoveResizeSink::collect()
+{
+    if (!isActive()) {
+        return;
+    }
+    while (xcb_generic_event_t * const event = xcb_poll_for_event(m_connection)) {
+        if ((event->response_type & ~0x80) == XCB_CLIENT_MESSAGE) {
+            const auto cme = reinterpret_cast<const xcb_client_message_event_t *>(event);
+            if ((cme->type == m_moveResizeAtom) && (cme->format == 32)) {
+                Message message = {};
+                message.window = cme->window;
+                message.globalPos = QPoint(int(cme->data.data32[0]), int(cme->data.data32[1]));
+                message.action = cme->data.data32[2];
+                message.button = cme->data.data32[3];
+                message.timestamp = m_clock.nsecsElapsed();
+                m_messages.append(message);
+            }
+        }
+        std::free(event);
+    }
+}
+
+std::optional<MoveResizeSink::Message> MoveResizeSink::takeMessage(const WId windowId, const int timeout)
+{
+    if (!isActive()) {
+        return std::nullopt;
+    }
+    QElapsedTimer timer = {};
+    timer.start();
+    do {
+        collect();
+        const auto it = std::find_if(m_messages.begin(), m_messages.end(), [windowId](const Message &message){
+            return (message.window == xcb_window_t(windowId));
+        });
+        if (it != m_messages.end()) {
+            const Message message = *it;
+            m_messages.erase(it);
+            return message;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+    } while (timer.elapsed() < timeout);
+    return std::nullopt;
+}
+#endif // FRAMELESSHELPER_BENCHMARKS_MOVERESIZE_SINK
+
+// Counts the frames the window actually painted while the interaction was running.
+class PaintCounter : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(PaintCounter)
+
+public:
+    explicit PaintCounter(QWindow *window, QObject *parent = nullptr) : QObject(parent), m_window(window)
+    {
+        Q_ASSERT(m_window);
+#if FRAMELESSHELPER_CONFIG(quick)
+        if (const auto quickWindow = qobject_cast<QQuickWindow *>(m_window)) {
+            connect(quickWindow, &QQuickWindow::frameSwapped, this, [this](){ ++m_count; });
+            return;
+        }
+#endif
+        qApp->installEventFilter(this);
+    }
+
+    ~PaintCounter() override = default;
+
+    [[nodiscard]] quint64 count() const
+    {
+        return m_count;
+    }
+
+    void reset()
+    {
+        m_count = 0;
+    }
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint) {
+            if (const auto widget = qobject_cast<QWidget *>(object)) {
+                if (widget->window()->windowHandle() == m_window) {
+                    ++m_count;
+                }
+            }
+        }
+        return QObject::eventFilter(object, event);
+    }
+
+private:
+    QWindow *m_window = nullptr;
+    quint64 m_count = 0;
+};
+
+// One frameless top level window of any of the supported kinds.
+struct Subject
+{
+    std::unique_ptr<QWidget> widget = nullptr;
+#if FRAMELESSHELPER_CONFIG(quick)
+    std::unique_ptr<QQmlApplicationEngine> engine = nullptr;
+#endif
+    QWindow *window = nullptr;
+    std::unique_ptr<PaintCounter> paints = nullptr;
+};
+
+struct LatencyStatistics
+{
+    int count = 0;
+    qint64 p50 = 0; // Nanoseconds.
+    qint64 p99 = 0; // Nanoseconds.
+    qint64 maximum = 0; // Nanoseconds.
+};
+
+[[nodiscard]] static inline LatencyStatistics calculateLatency(QList<qint64> samples)
+{
+    if (samples.isEmpty()) {
+        return {};
+    }
+    std::sort(samples.begin(), samples.end());
+    // Nearest rank, so that the percentiles are always real samples.
+    const auto percentile = [&samples](const qreal p) -> qint64 {
+        const int rank = int(std::ceil(p * qreal(samples.size())));
+        return samples.at(std::clamp(rank - 1, 0, int(samples.size() - 1)));
+    };
+    LatencyStatistics result = {};
+    result.count = int(samples.size());
+    result.p50 = percentile(0.5);
+    result.p99 = percentile(0.99);
+    result.maximum = samples.constLast();
+    return result;
+}
+
+[[nodiscard]] static inline qreal toMilliseconds(const qint64 ns)
+{
+    return (qreal(ns) / qreal(1000000));
+}
+
+class tst_Interaction : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void hoverSystemButtons_data();
+    void hoverSystemButtons();
+    void titleBarDrag_data();
+    void titleBarDrag();
+    void edgeResize_data();
+    void edgeResize();
+    void doubleClickMaximize_data();
+    void doubleClickMaximize();
+    void moveResizeMessage_data();
+    void moveResizeMessage();
+
+private:
+    static void addWindowKinds();
+    [[nodiscard]] static std::unique_ptr<Subject> createSubject(const WindowKind kind);
+    static void resetCounters(Subject *subject);
+    static void report(const char *scenario, const Subject *subject, const QList<qint64> &samples, const QList<qint64> &moveResizeSamples);
+};
+
+void tst_Interaction::initTestCase()
+{
+#if FRAMELESSHELPER_CONFIG(native_impl)
+    QSKIP("The synthetic events bypass the native implementation's hit testing.");
+#elif !(FRAMELESSHELPER_CONFIG(window) && FRAMELESSHELPER_CONFIG(titlebar))
+    QSKIP("The frameless windows or the standard title bar are not available in this build.");
+#endif
+}
+
+void tst_Interaction::addWindowKinds()
+{
+    QTest::addColumn<WindowKind>("kind");
+    QTest::newRow("FramelessWidget") << WindowKind::Widget;
+    QTest::newRow("FramelessMainWindow") << WindowKind::MainWindow;
+    QTest::newRow("FramelessQuickWindow") << WindowKind::QuickWindow;
+}
+
+std::unique_ptr<Subject> tst_Interaction::createSubject(const WindowKind kind)
+{
+    auto subject = std::make_unique<Subject>();
+#if (FRAMELESSHELPER_CONFIG(window) && FRAMELESSHELPER_CONFIG(titlebar))
+    if (kind == WindowKind::Widget) {
+        auto widget = std::make_unique<FramelessWidget>();
+        const auto titleBar = new StandardTitleBar(widget.get());
+        const auto layout = new QVBoxLayout(widget.get());
+        layout->setContentsMargins(0, 0, 0, 0);
+        layout->setSpacing(0);
+        layout->addWidget(titleBar);
+        layout->addStretch();
+        FramelessWidgetsHelper::get(widget.get())->setTitleBarWidget(titleBar);
+        subject->widget = std::move(widget);
+    } else if (kind == WindowKind::MainWindow) {
+        auto mainWindow = std::make_unique<FramelessMainWindow>();
+        const auto titleBar = new StandardTitleBar(mainWindow.get());
+        mainWindow->setMenuWidget(titleBar);
+        mainWindow->setCentralWidget(new QWidget(mainWindow.get()));
+        FramelessWidgetsHelper::get(mainWindow.get())->setTitleBarWidget(titleBar);
+        subject->widget = std::move(mainWindow);
+    }
+#endif
+    if (subject->widget) {
+        subject->widget->resize(kWindowSize);
+        subject->widget->show();
+        if (!QTest::qWaitForWindowExposed(subject->widget.get())) {
+            return nullptr;
+        }
+        FramelessWidgetsHelper * const helper = FramelessWidgetsHelper::get(subject->widget.get());
+        if (!QTest::qWaitFor([helper](){ return helper->isReady(); })) {
+            return nullptr;
+        }
+        subject->window = subject->widget->windowHandle();
+    }
+#if (FRAMELESSHELPER_CONFIG(quick) && FRAMELESSHELPER_CONFIG(private_qt) && FRAMELESSHELPER_CONFIG(window) \
+    && FRAMELESSHELPER_CONFIG(titlebar) && (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)))
+    if (kind == WindowKind::QuickWindow) {
+        subject->engine = std::make_unique<QQmlApplicationEngine>();
+        FramelessHelperQuickRegisterTypes(subject->engine.get());
+        subject->engine->loadData(FRAMELESSHELPER_BYTEARRAY_LITERAL(R"(
+import QtQuick
+import org.wangwenx190.FramelessHelper
+
+FramelessWindow {
+    width: 800
+    height: 600
+    visible: true
+
+    StandardTitleBar {
+        id: titleBar
+        anchors {
+            top: parent.top
+            left: parent.left
+            right: parent.right
+        }
+    }
+
+    FramelessHelper.onReady: FramelessHelper.titleBarItem = titleBar
+}
+)"));
+        const QList<QObject *> roots = subject->engine->rootObjects();
+        const auto quickWindow = (roots.isEmpty() ? nullptr : qobject_cast<QQuickWindow *>(roots.constFirst()));
+        if (!quickWindow || !QTest::qWaitForWindowExposed(quickWindow)) {
+            return nullptr;
+        }
+        FramelessQuickHelper * const helper = FramelessQuickHelper::get(quickWindow);
+        if (!helper || !QTest::qWaitFor([helper](){ return helper->isReady(); })) {
+            return nullptr;
+        }
+        subject->window = quickWindow;
+    }
+#endif
+    if (!subject->window) {
+        return nullptr;
+    }
+    subject->paints = std::make_unique<PaintCounter>(subject->window);
+    return subject;
+}
+
+void tst_Interaction::resetCounters(Subject *subject)
+{
+    Q_ASSERT(subject);
+    if (!subject) {
+        return;
+    }
+    // Let the initial frames and any pending layout settle before we start counting.
+    QCoreApplication::processEvents();
+    subject->paints->reset();
+    if (FramelessManager::isPerformanceCountersEnabled()) {
+        FramelessManager::instance()->resetPerformanceCounters();
+    }
+#ifdef FRAMELESSHELPER_BENCHMARKS_MOVERESIZE_SINK
+    if (MoveResizeSink * const sink = MoveResizeSink::instance()) {
+        sink->clear();
+    }
+#endif
+}
+
+void tst_Interaction::report(const char *scenario, const Subject *subject, const QList<qint64> &samples, const QList<qint64> &moveResizeSamples)
+{
+    Q_ASSERT(scenario);
+    Q_ASSERT(subject);
+    if (!scenario || !subject) {
+        return;
+    }
+    const LatencyStatistics latency = calculateLatency(samples);
+    QTest::setBenchmarkResult(toMilliseconds(latency.p99), QTest::WalltimeMilliseconds);
+    qInfo().noquote().nospace() << scenario << " [" << QTest::currentDataTag() << "]: "
+        << latency.count << " events, p50 " << toMilliseconds(latency.p50) << " ms, p99 "
+        << toMilliseconds(latency.p99) << " ms, max " << toMilliseconds(latency.maximum)
+        << " ms, " << subject->paints->count() << " paints";
+    if (!moveResizeSamples.isEmpty()) {
+        const LatencyStatistics moveResize = calculateLatency(moveResizeSamples);
+        qInfo().noquote().nospace() << "    _NET_WM_MOVERESIZE: " << moveResize.count << " messages, p50 "
+            << toMilliseconds(moveResize.p50) << " ms, p99 " << toMilliseconds(moveResize.p99) << " ms";
+    }
+    if (FramelessManager::isPerformanceCountersEnabled()) {
+        const FramelessManager * const manager = FramelessManager::instance();
+        const PerformanceTimerStatistics eventHandling = manager->performanceTimer(PerformanceTimer::EventHandling);
+        const qint64 average = (eventHandling.count ? qint64(eventHandling.totalTime / eventHandling.count) : 0);
+        qInfo().noquote().nospace() << "    counters: " << manager->performanceCounter(PerformanceCounter::FilteredEvents)
+            << " filtered events, " << manager->performanceCounter(PerformanceCounter::WindowPaints)
+            << " window paints (" << manager->performanceCounter(PerformanceCounter::PaintedPixels)
+            << " pixels), event handling avg " << toMilliseconds(average) << " ms, max "
+            << toMilliseconds(qint64(eventHandling.maximumTime)) << " ms";
+    }
+}
+
+// Runs one synthetic input step and waits for everything it posted to be handled.
+template<typename Function>
+[[nodiscard]] static inline qint64 measure(Function &&function)
+{
+    QElapsedTimer timer = {};
+    timer.start();
+    function();
+    QCoreApplication::processEvents();
+    return timer.nsecsElapsed();
+}
+
+void tst_Interaction::hoverSystemButtons_data()
+{
+    addWindowKinds();
+}
+
+void tst_Interaction::hoverSystemButtons()
+{
+    QFETCH(WindowKind, kind);
+    const std::unique_ptr<Subject> subject = createSubject(kind);
+    if (!subject) {
+        QSKIP("This kind of window is not available in this build.");
+    }
+    QWindow * const window = subject->window;
+    const int y = (kDefaultTitleBarHeight / 2);
+    resetCounters(subject.get());
+    QList<qint64> samples = {};
+    // Sweep over the whole title bar, the system buttons sit at its right end and each one
+    // of them gets entered and left several times per pass.
+    for (int i = 0; i != (kIterations / 5); ++i) {
+        for (int x = 0; x < window->width(); x += kHoverStep) {
+            samples.append(measure([window, x, y](){ QTest::mouseMove(window, QPoint(x, y)); }));
+        }
+        samples.append(measure([window](){ QTest::mouseMove(window, QPoint(window->width() / 2, window->height() / 2)); }));
+    }
+    report("hoverSystemButtons", subject.get(), samples, {});
+}
+
+void tst_Interaction::titleBarDrag_data()
+{
+    addWindowKinds();
+}
+
+void tst_Interaction::titleBarDrag()
+{
+    QFETCH(WindowKind, kind);
+    const std::unique_ptr<Subject> subject = createSubject(kind);
+    if (!subject) {
+        QSKIP("This kind of window is not available in this build.");
+    }
+    QWindow * const window = subject->window;
+    const QPoint pos = QPoint(window->width() / 3, kDefaultTitleBarHeight / 2);
+    resetCounters(subject.get());
+    QList<qint64> samples = {};
+    QList<qint64> moveResizeSamples = {};
+    for (int i = 0; i != kIterations; ++i) {
+        samples.append(measure([window, &pos](){ QTest::mousePress(window, Qt::LeftButton, Qt::NoModifier, pos); }));
+#ifdef FRAMELESSHELPER_BENCHMARKS_MOVERESIZE_SINK
+        MoveResizeSink * const sink = MoveResizeSink::instance();
+        const qint64 dragStart = (sink ? sink->clock().nsecsElapsed() : 0);
+#endif
+        // The first move with the left button held down starts the system move.
+        samples.append(measure([window, &pos](){ QTest::mouseMove(window, pos + QPoint(10, 0)); }));
+#ifdef FRAMELESSHELPER_BENCHMARKS_MOVERESIZE_SINK
+        if (sink) {
+            if (const auto message = sink->takeMessage(window->winId(), kMessageTimeout)) {
+                QCOMPARE(message->action, quint32(_NET_WM_MOVERESIZE_MOVE));
+                moveResizeSamples.append(message->timestamp - dragStart);
+            }
+        }
+#endif
+        samples.append(measure([window, &pos](){ QTest::mouseMove(window, pos + QPoint(20, 0)); }));
+        samples.append(measure([window, &pos](){ QTest::mouseRelease(window, Qt::LeftButton, Qt::NoModifier, pos + QPoint(20, 0)); }));
+    }
+    report("titleBarDrag", subject.get(), samples, moveResizeSamples);
+}
+
+void tst_Interaction::edgeResize_data()
+{
+    addWindowKinds();
+}
+
+void tst_Interaction::edgeResize()
+{
+    QFETCH(WindowKind, kind);
+    const std::unique_ptr<Subject> subject = createSubject(kind);
+    if (!subject) {
+        QSKIP("This kind of window is not available in this build.");
+    }
+    QWindow * const window = subject->window;
+    const QPoint pos = QPoint(window->width() - 2, window->height() - 2);
+    resetCounters(subject.get());
+    QList<qint64> samples = {};
+    QList<qint64> moveResizeSamples = {};
+    for (int i = 0; i != kIterations; ++i) {
+        samples.append(measure([window, &pos](){ QTest::mouseMove(window, pos); }));
+#ifdef FRAMELESSHELPER_BENCHMARKS_MOVERESIZE_SINK
+        MoveResizeSink * const sink = MoveResizeSink::instance();
+        const qint64 resizeStart = (sink ? sink->clock().nsecsElapsed() : 0);
+#endif
+        // Pressing inside the resize border starts the system resize right away.
+        samples.append(measure([window, &pos](){ QTest::mousePress(window, Qt::LeftButton, Qt::NoModifier, pos); }));
+#ifdef FRAMELESSHELPER_BENCHMARKS_MOVERESIZE_SINK
+        if (sink) {
+            if (const auto message = sink->takeMessage(window->winId(), kMessageTimeout)) {
+                QCOMPARE(message->action, quint32(_NET_WM_MOVERESIZE_SIZE_BOTTOMRIGHT));
+                moveResizeSamples.append(message->timestamp - resizeStart);
+            }
+        }
+#endif
+        samples.append(measure([window, &pos](){ QTest::mouseRelease(window, Qt::LeftButton, Qt::NoModifier, pos); }));
+    }
+    report("edgeResize", subject.get(), samples, moveResizeSamples);
+}
+
+void tst_Interaction::doubleClickMaximize_data()
+{
+    addWindowKinds();
+}
+
+void tst_Interaction::doubleClickMaximize()
+{
+    QFETCH(WindowKind, kind);
+    const std::unique_ptr<Subject> subject = createSubject(kind);
+    if (!subject) {
+        QSKIP("This kind of window is not available in this build.");
+    }
+    QWindow * const window = subject->window;
+    const QPoint pos = QPoint(window->width() / 3, kDefaultTitleBarHeight / 2);
+    resetCounters(subject.get());
+    QList<qint64> samples = {};
+    int toggles = 0;
+    // Every double click flips the window between maximized and normal.
+    for (int i = 0; i != kIterations; ++i) {
+        const bool wasMaximized = window->windowStates().testFlag(Qt::WindowMaximized);
+        samples.append(measure([window, &pos](){ QTest::mouseDClick(window, Qt::LeftButton, Qt::NoModifier, pos); }));
+        if (window->windowStates().testFlag(Qt::WindowMaximized) != wasMaximized) {
+            ++toggles;
+        }
+    }
+    if (window->windowStates().testFlag(Qt::WindowMaximized)) {
+        window->showNormal();
+    }
+    qInfo().noquote().nospace() << "doubleClickMaximize [" << QTest::currentDataTag() << "]: "
+        << toggles << '/' << kIterations << " double clicks toggled the maximized state";
+    report("doubleClickMaximize", subject.get(), samples, {});
+}
+
+void tst_Interaction::moveResizeMessage_data()
+{
+    QTest::addColumn<quint32>("action");
+#ifdef Q_OS_LINUX
+    QTest::newRow("size top left") << quint32(_NET_WM_MOVERESIZE_SIZE_TOPLEFT);
+    QTest::newRow("size top") << quint32(_NET_WM_MOVERESIZE_SIZE_TOP);
+    QTest::newRow("size top right") << quint32(_NET_WM_MOVERESIZE_SIZE_TOPRIGHT);
+    QTest::newRow("size right") << quint32(_NET_WM_MOVERESIZE_SIZE_RIGHT);
+    QTest::newRow("size bottom right") << quint32(_NET_WM_MOVERESIZE_SIZE_BOTTOMRIGHT);
+    QTest::newRow("size bottom") << quint32(_NET_WM_MOVERESIZE_SIZE_BOTTOM);
+    QTest::newRow("size bottom left") << quint32(_NET_WM_MOVERESIZE_SIZE_BOTTOMLEFT);
+    QTest::newRow("size left") << quint32(_NET_WM_MOVERESIZE_SIZE_LEFT);
+    QTest::newRow("move") << quint32(_NET_WM_MOVERESIZE_MOVE);
+    QTest::newRow("cancel") << quint32(_NET_WM_MOVERESIZE_CANCEL);
+#endif
+}
+
+void tst_Interaction::moveResizeMessage()
+{
+#ifndef FRAMELESSHELPER_BENCHMARKS_MOVERESIZE_SINK
+    QSKIP("The _NET_WM_MOVERESIZE sink needs Linux and libxcb.");
+#else
+    MoveResizeSink * const sink = MoveResizeSink::instance();
+    if (!sink || !sink->isActive()) {
+        QSKIP("The _NET_WM_MOVERESIZE sink is only available on the XCB platform.");
+    }
+    QFETCH(quint32, action);
+    const std::unique_ptr<Subject> subject = createSubject(WindowKind::Widget);
+    QVERIFY(subject);
+    const WId windowId = subject->window->winId();
+    const QPoint globalPos = subject->window->mapToGlobal(QPoint(10, 10));
+    resetCounters(subject.get());
+    QList<qint64> samples = {};
+    for (int i = 0; i != kIterations; ++i) {
+        const qint64 sent = sink->clock().nsecsElapsed();
+        Utils::sendMoveResizeMessage(windowId, action, globalPos);
+        const auto message = sink->takeMessage(windowId, kMessageTimeout);
+        QVERIFY2(message, "Utils::sendMoveResizeMessage() didn't reach the root window.");
+        QCOMPARE(message->action, action);
+        QCOMPARE(message->globalPos, globalPos);
+        QCOMPARE(message->button, quint32(XCB_BUTTON_INDEX_1));
+        samples.append(message->timestamp - sent);
+    }
+    report("moveResizeMessage", subject.get(), samples, {});
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    Benchmark::initialize([](){
+        FramelessHelperWidgetsInitialize();
+#if FRAMELESSHELPER_CONFIG(quick)
+        FramelessHelperQuickInitialize();
+#endif
+    });
+#ifdef FRAMELESSHELPER_BENCHMARKS_MOVERESIZE_SINK
+    // Must be in place before the QApplication connects to the X server, see MoveResizeSink.
+    std::unique_ptr<MoveResizeSink> sink = nullptr;
+    if (qgetenv("QT_QPA_PLATFORM").startsWith("xcb")) {
+        sink = std::make_unique<MoveResizeSink>();
+        MoveResizeSink::setInstance(sink.get());
+    }
+#endif
+#if (FRAMELESSHELPER_CONFIG(quick) && (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)))
+    // Same renderer everywhere, the offscreen platform and Xvfb have no GPU anyway.
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+#endif
+    QApplication application(argc, argv);
+    tst_Interaction test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_interaction.moc"
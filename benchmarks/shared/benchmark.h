@@ -0,0 +1,80 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+
+namespace Benchmark
+{
+    // FramelessHelper forces the XCB platform plugin on Linux when it's being initialized,
+    // keep the one the test runner asked for instead (usually "offscreen").
+    template<typename Initializer>
+    inline void initialize(Initializer &&initializer)
+    {
+        const QByteArray platform = qgetenv("QT_QPA_PLATFORM");
+        initializer();
+        if (!platform.isEmpty()) {
+            qputenv("QT_QPA_PLATFORM", platform);
+        }
+    }
+
+    // A system library which is always available, and some of its exported functions,
+    // used to exercise the SysApiLoader without depending on any optional packages.
+    [[nodiscard]] inline QString systemLibrary()
+    {
+#if defined(Q_OS_WINDOWS)
+        return FRAMELESSHELPER_STRING_LITERAL("kernel32");
+#elif defined(Q_OS_MACOS)
+        return FRAMELESSHELPER_STRING_LITERAL("/usr/lib/libSystem.B.dylib");
+#else
+        return FRAMELESSHELPER_STRING_LITERAL("libm.so.6");
+#endif
+    }
+
+    [[nodiscard]] inline QStringList systemFunctions()
+    {
+#ifdef Q_OS_WINDOWS
+        return {
+            FRAMELESSHELPER_STRING_LITERAL("GetTickCount"), FRAMELESSHELPER_STRING_LITERAL("GetTickCount64"),
+            FRAMELESSHELPER_STRING_LITERAL("GetCurrentProcessId"), FRAMELESSHELPER_STRING_LITERAL("GetCurrentThreadId"),
+            FRAMELESSHELPER_STRING_LITERAL("GetLastError"), FRAMELESSHELPER_STRING_LITERAL("SetLastError"),
+            FRAMELESSHELPER_STRING_LITERAL("Sleep"), FRAMELESSHELPER_STRING_LITERAL("QueryPerformanceCounter"),
+            FRAMELESSHELPER_STRING_LITERAL("QueryPerformanceFrequency"), FRAMELESSHELPER_STRING_LITERAL("GetSystemInfo"),
+            FRAMELESSHELPER_STRING_LITERAL("GetVersion"), FRAMELESSHELPER_STRING_LITERAL("GetProcessHeap")
+        };
+#else
+        return {
+            FRAMELESSHELPER_STRING_LITERAL("cos"), FRAMELESSHELPER_STRING_LITERAL("sin"), FRAMELESSHELPER_STRING_LITERAL("tan"),
+            FRAMELESSHELPER_STRING_LITERAL("acos"), FRAMELESSHELPER_STRING_LITERAL("asin"), FRAMELESSHELPER_STRING_LITERAL("atan"),
+            FRAMELESSHELPER_STRING_LITERAL("exp"), FRAMELESSHELPER_STRING_LITERAL("log"), FRAMELESSHELPER_STRING_LITERAL("pow"),
+            FRAMELESSHELPER_STRING_LITERAL("sqrt"), FRAMELESSHELPER_STRING_LITERAL("floor"), FRAMELESSHELPER_STRING_LITERAL("ceil")
+        };
+#endif
+    }
+} // namespace Benchmark
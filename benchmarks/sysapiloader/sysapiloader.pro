@@ -0,0 +1,9 @@
+TEMPLATE = app
+TARGET = tst_sysapiloader
+QT += testlib
+CONFIG += testcase
+HEADERS += \
+    ../shared/benchmark.h
+SOURCES += \
+    tst_sysapiloader.cpp
+include(../../qmake/core.pri)
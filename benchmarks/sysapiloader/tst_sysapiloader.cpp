@@ -0,0 +1,136 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <QtTest/qtest.h>
+#include <QtCore/qcoreapplication.h>
+#include <FramelessHelper/Core/private/sysapiloader_p.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../shared/benchmark.h"
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+static constexpr const int kThreadCount = 16;
+static constexpr const int kIterationCount = 200;
+
+class tst_SysApiLoader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    // Runs first on purpose, the preloader has to find the cache empty.
+    void preloadWhileResolving();
+    void concurrentResolve();
+};
+
+void tst_SysApiLoader::preloadWhileResolving()
+{
+    const QString library = Benchmark::systemLibrary();
+    const QStringList functions = Benchmark::systemFunctions();
+    if (!SysApiLoader::resolve(library, functions.constFirst())) {
+        QSKIP("The test library can't be loaded on this system.");
+    }
+
+    SysApiLoader * const loader = SysApiLoader::instance();
+    loader->preload({ { library, functions } });
+    // Race the preloader: whoever comes first inserts the symbol, the other one has to
+    // pick up exactly the same pointer.
+    for (int iteration = 0; iteration != kIterationCount; ++iteration) {
+        for (auto &&function : std::as_const(functions)) {
+            QCOMPARE(loader->getOrResolve(library, function), SysApiLoader::resolve(library, function));
+        }
+    }
+}
+
+void tst_SysApiLoader::concurrentResolve()
+{
+    const QString library = Benchmark::systemLibrary();
+    QStringList functions = Benchmark::systemFunctions();
+    // Symbols which don't exist have to be cached (as null) consistently too.
+    for (int i = 0; i != 4; ++i) {
+        functions.append(FRAMELESSHELPER_STRING_LITERAL("framelesshelper_missing_symbol_%1").arg(i));
+    }
+    const auto count = int(functions.size());
+
+    // The reference values, resolved directly without going through the cache.
+    std::vector<QFunctionPointer> expected = {};
+    expected.reserve(count);
+    for (auto &&function : std::as_const(functions)) {
+        expected.push_back(SysApiLoader::resolve(library, function));
+    }
+    if (!expected.front()) {
+        QSKIP("The test library can't be loaded on this system.");
+    }
+
+    // Every thread walks the same symbols starting from a different offset, so that
+    // each symbol is looked up and inserted by several threads at the same time.
+    std::vector<std::vector<QFunctionPointer>> results(kThreadCount, std::vector<QFunctionPointer>(count, nullptr));
+    std::atomic<int> mismatches = 0;
+    std::atomic<bool> go = false;
+    std::vector<std::thread> threads = {};
+    threads.reserve(kThreadCount);
+    for (int t = 0; t != kThreadCount; ++t) {
+        threads.emplace_back([&, t](){
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            SysApiLoader * const loader = SysApiLoader::instance();
+            for (int iteration = 0; iteration != kIterationCount; ++iteration) {
+                for (int i = 0; i != count; ++i) {
+                    const int index = ((i + t) % count);
+                    const QString &function = functions.at(index);
+                    // Alternate between the inserting and the read-only paths.
+                    const QFunctionPointer symbol = (((iteration + t) % 2) == 0)
+                        ? loader->getOrResolve(library, function)
+                        : (loader->isAvailable(library, function) ? loader->get(library, function) : nullptr);
+                    if (iteration == 0) {
+                        results.at(t).at(index) = symbol;
+                    } else if (symbol != results.at(t).at(index)) {
+                        mismatches.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+    }
+    go.store(true, std::memory_order_release);
+    for (auto &&thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(mismatches.load(), 0);
+    for (int t = 0; t != kThreadCount; ++t) {
+        for (int i = 0; i != count; ++i) {
+            if (results.at(t).at(i) != expected.at(i)) {
+                QFAIL(qPrintable(FRAMELESSHELPER_STRING_LITERAL("Thread %1 got a wrong pointer for %2.")
+                    .arg(QString::number(t), functions.at(i))));
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_SysApiLoader)
+
+#include "tst_sysapiloader.moc"
@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <QtTest/qtest.h>
+#include <QtGui/qevent.h>
+#include <QtGui/qwindow.h>
+#include <QtWidgets/qapplication.h>
+#include <QtWidgets/qwidget.h>
+#include <FramelessHelper/Widgets/framelesswidgetshelper.h>
+#include <FramelessHelper/Widgets/private/framelesswidgetshelper_p.h>
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include "../shared/benchmark.h"
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+static constexpr const QSize kWindowSize = { 800, 600 };
+static constexpr const int kTitleBarHeight = 32;
+
+class tst_BenchWidgets : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void titleBarHitTest_data();
+    void titleBarHitTest();
+    void eventFilterThroughput_data();
+    void eventFilterThroughput();
+
+private:
+    // Creates a frameless window whose title bar contains "count" hit test visible widgets,
+    // laid out from the left edge, the right end of the title bar stays draggable.
+    [[nodiscard]] static std::unique_ptr<QWidget> createWindow(const int count);
+};
+
+std::unique_ptr<QWidget> tst_BenchWidgets::createWindow(const int count)
+{
+    auto window = std::make_unique<QWidget>();
+    window->resize(kWindowSize);
+    const auto titleBar = new QWidget(window.get());
+    titleBar->setGeometry(0, 0, kWindowSize.width(), kTitleBarHeight);
+    FramelessWidgetsHelper * const helper = FramelessWidgetsHelper::get(window.get());
+    helper->extendsContentIntoTitleBar();
+    helper->setTitleBarWidget(titleBar);
+    const int width = std::max(1, ((kWindowSize.width() / 2) / std::max(count, 1)));
+    for (int i = 0; i != count; ++i) {
+        const auto control = new QWidget(titleBar);
+        control->setGeometry((i * width), 0, width, kTitleBarHeight);
+        helper->setHitTestVisible(control);
+    }
+    window->show();
+    return window;
+}
+
+void tst_BenchWidgets::titleBarHitTest_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("0 controls") << 0;
+    QTest::newRow("10 controls") << 10;
+    QTest::newRow("100 controls") << 100;
+    QTest::newRow("1000 controls") << 1000;
+}
+
+void tst_BenchWidgets::titleBarHitTest()
+{
+    QFETCH(int, count);
+    const std::unique_ptr<QWidget> window = createWindow(count);
+    QVERIFY(QTest::qWaitForWindowExposed(window.get()));
+    const FramelessWidgetsHelperPrivate * const d = FramelessWidgetsHelperPrivate::get(FramelessWidgetsHelper::get(window.get()));
+    const QPoint draggable = { (kWindowSize.width() - 10), (kTitleBarHeight / 2) };
+    const QPoint control = { 0, (kTitleBarHeight / 2) };
+    const QPoint client = { (kWindowSize.width() / 2), (kWindowSize.height() / 2) };
+    QVERIFY(d->isInTitleBarDraggableArea(draggable));
+    QCOMPARE(d->isInTitleBarDraggableArea(control), (count == 0));
+    QVERIFY(!d->isInTitleBarDraggableArea(client));
+    QBENCHMARK {
+        std::ignore = d->isInTitleBarDraggableArea(draggable);
+        std::ignore = d->isInTitleBarDraggableArea(control);
+        std::ignore = d->isInTitleBarDraggableArea(client);
+    }
+}
+
+void tst_BenchWidgets::eventFilterThroughput_data()
+{
+    QTest::addColumn<QPoint>("pos");
+    QTest::newRow("client area") << QPoint((kWindowSize.width() / 2), (kWindowSize.height() / 2));
+    QTest::newRow("title bar") << QPoint((kWindowSize.width() - 10), (kTitleBarHeight / 2));
+    QTest::newRow("window edge") << QPoint((kWindowSize.width() - 1), (kWindowSize.height() / 2));
+}
+
+void tst_BenchWidgets::eventFilterThroughput()
+{
+#if FRAMELESSHELPER_CONFIG(native_impl)
+    QSKIP("FramelessHelperQt is not used by the native implementation.");
+#else
+    QFETCH(QPoint, pos);
+    const std::unique_ptr<QWidget> window = createWindow(10);
+    QVERIFY(QTest::qWaitForWindowExposed(window.get()));
+    QWindow * const handle = window->windowHandle();
+    QVERIFY(handle);
+    const QPointF localPos = QPointF(pos);
+    const QPointF globalPos = QPointF(handle->mapToGlobal(pos));
+    // Every event goes through FramelessHelperQt's event filter installed on the QWindow,
+    // and then through the normal widget dispatching, just like a real mouse move.
+    QBENCHMARK {
+        QMouseEvent event(QEvent::MouseMove, localPos, localPos, globalPos, Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+        QCoreApplication::sendEvent(handle, &event);
+    }
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    Benchmark::initialize(FramelessHelperWidgetsInitialize);
+    QApplication application(argc, argv);
+    tst_BenchWidgets test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_bench_widgets.moc"
@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_widgets
+QT += testlib widgets
+CONFIG += testcase
+SOURCES += \
+    tst_bench_widgets.cpp
+include(../../qmake/core.pri)
+include(../../qmake/widgets.pri)
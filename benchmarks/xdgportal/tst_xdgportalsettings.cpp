@@ -0,0 +1,226 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <QtTest/qtest.h>
+#include <QtTest/qsignalspy.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qprocess.h>
+#include <QtCore/qstandardpaths.h>
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+#  include <QtDBus/qdbusargument.h>
+#  include <QtDBus/qdbusconnection.h>
+#  include <QtDBus/qdbusextratypes.h>
+#  include <QtDBus/qdbusmetatype.h>
+#  include <FramelessHelper/Core/private/xdgportalsettings_p.h>
+#endif
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+using namespace Global;
+
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+
+using PortalSettings = QMap<QString, QVariantMap>;
+Q_DECLARE_METATYPE(PortalSettings)
+
+static const QString kPortalService = FRAMELESSHELPER_STRING_LITERAL("org.freedesktop.portal.Desktop");
+static const QString kPortalPath = FRAMELESSHELPER_STRING_LITERAL("/org/freedesktop/portal/desktop");
+static const QString kAppearanceGroup = FRAMELESSHELPER_STRING_LITERAL("org.freedesktop.appearance");
+static const QString kBackgroundGroup = FRAMELESSHELPER_STRING_LITERAL("org.gnome.desktop.background");
+static const QString kColorSchemeKey = FRAMELESSHELPER_STRING_LITERAL("color-scheme");
+static const QString kAccentColorKey = FRAMELESSHELPER_STRING_LITERAL("accent-color");
+static const QString kPictureUriKey = FRAMELESSHELPER_STRING_LITERAL("picture-uri");
+static const QString kPictureUriDarkKey = FRAMELESSHELPER_STRING_LITERAL("picture-uri-dark");
+static const QString kPictureOptionsKey = FRAMELESSHELPER_STRING_LITERAL("picture-options");
+
+[[nodiscard]] static inline QVariant accentColorValue(const double red, const double green, const double blue)
+{
+    QDBusArgument argument;
+    argument.beginStructure();
+    argument << red << green << blue;
+    argument.endStructure();
+    return QVariant::fromValue(argument);
+}
+
+// A minimal implementation of the "org.freedesktop.portal.Settings" interface.
+class FakePortal : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.portal.Settings")
+
+public:
+    explicit FakePortal(QObject *parent = nullptr) : QObject(parent) {}
+    ~FakePortal() override = default;
+
+    PortalSettings settings = {};
+
+    void change(const QString &group, const QString &key, const QVariant &value)
+    {
+        settings[group][key] = value;
+        Q_EMIT SettingChanged(group, key, QDBusVariant(value));
+    }
+
+public Q_SLOTS:
+    Q_SCRIPTABLE PortalSettings ReadAll(const QStringList &groups)
+    {
+        PortalSettings result = {};
+        for (auto &&group : std::as_const(groups)) {
+            if (settings.contains(group)) {
+                result.insert(group, settings.value(group));
+            }
+        }
+        return result;
+    }
+
+Q_SIGNALS:
+    Q_SCRIPTABLE void SettingChanged(const QString &group, const QString &key, const QDBusVariant &value);
+};
+
+#endif // FRAMELESSHELPER_CONFIG(xdg_portal)
+
+class tst_XdgPortalSettings : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void initialSnapshot();
+    void settingChanged();
+    void noPreference();
+
+private:
+    QProcess m_bus;
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+    FakePortal m_portal;
+#endif
+};
+
+void tst_XdgPortalSettings::initTestCase()
+{
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+    // Everything runs against a private session bus, never touch the user's one.
+    const QString daemon = QStandardPaths::findExecutable(FRAMELESSHELPER_STRING_LITERAL("dbus-daemon"));
+    if (daemon.isEmpty()) {
+        QSKIP("dbus-daemon is not available.");
+    }
+    m_bus.start(daemon, { FRAMELESSHELPER_STRING_LITERAL("--session"),
+        FRAMELESSHELPER_STRING_LITERAL("--nofork"), FRAMELESSHELPER_STRING_LITERAL("--print-address") });
+    QVERIFY(m_bus.waitForStarted());
+    QVERIFY(m_bus.waitForReadyRead(10000));
+    const QByteArray address = m_bus.readLine().trimmed();
+    QVERIFY(!address.isEmpty());
+    qputenv("DBUS_SESSION_BUS_ADDRESS", address);
+
+    qDBusRegisterMetaType<PortalSettings>();
+    m_portal.settings[kAppearanceGroup][kColorSchemeKey] = QVariant::fromValue(quint32(1)); // Prefer dark.
+    m_portal.settings[kAppearanceGroup][kAccentColorKey] = accentColorValue(0.2, 0.4, 0.6);
+    m_portal.settings[kBackgroundGroup][kPictureUriKey] = FRAMELESSHELPER_STRING_LITERAL("file:///tmp/light.png");
+    m_portal.settings[kBackgroundGroup][kPictureUriDarkKey] = FRAMELESSHELPER_STRING_LITERAL("file:///tmp/dark.png");
+    m_portal.settings[kBackgroundGroup][kPictureOptionsKey] = FRAMELESSHELPER_STRING_LITERAL("scaled");
+
+    // The fake portal lives on its own connection, just like a real portal process would.
+    QDBusConnection connection = QDBusConnection::connectToBus(QString::fromUtf8(address),
+        FRAMELESSHELPER_STRING_LITERAL("framelesshelper_fake_portal"));
+    QVERIFY(connection.isConnected());
+    QVERIFY(connection.registerObject(kPortalPath, &m_portal,
+        QDBusConnection::ExportScriptableSlots | QDBusConnection::ExportScriptableSignals));
+    QVERIFY(connection.registerService(kPortalService));
+#else
+    QSKIP("The XDG desktop portal support is disabled in this configuration.");
+#endif
+}
+
+void tst_XdgPortalSettings::cleanupTestCase()
+{
+    if (m_bus.state() != QProcess::NotRunning) {
+        m_bus.terminate();
+        m_bus.waitForFinished();
+    }
+}
+
+void tst_XdgPortalSettings::initialSnapshot()
+{
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+    XdgPortalSettings * const settings = XdgPortalSettings::instance();
+    QSignalSpy loadedSpy(settings, &XdgPortalSettings::settingsLoaded);
+    // The settings are read asynchronously, nothing is known before the reply arrives.
+    QVERIFY(!settings->isAvailable());
+    QVERIFY(!settings->shouldAppsUseDarkMode().has_value());
+    QTRY_COMPARE(loadedSpy.count(), 1);
+    QVERIFY(settings->isAvailable());
+    QCOMPARE(settings->shouldAppsUseDarkMode(), std::optional<bool>(true));
+    QCOMPARE(settings->accentColor(), std::optional<QColor>(QColor::fromRgbF(0.2, 0.4, 0.6)));
+    QCOMPARE(settings->wallpaperFilePath(), std::optional<QString>(FRAMELESSHELPER_STRING_LITERAL("/tmp/dark.png")));
+    QCOMPARE(settings->wallpaperAspectStyle(), std::optional<WallpaperAspectStyle>(WallpaperAspectStyle::Fit));
+#endif
+}
+
+void tst_XdgPortalSettings::settingChanged()
+{
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+    XdgPortalSettings * const settings = XdgPortalSettings::instance();
+    QSignalSpy colorSchemeSpy(settings, &XdgPortalSettings::colorSchemeChanged);
+    QSignalSpy accentColorSpy(settings, &XdgPortalSettings::accentColorChanged);
+    QSignalSpy wallpaperSpy(settings, &XdgPortalSettings::wallpaperChanged);
+
+    m_portal.change(kAppearanceGroup, kColorSchemeKey, QVariant::fromValue(quint32(2))); // Prefer light.
+    QTRY_COMPARE(colorSchemeSpy.count(), 1);
+    QCOMPARE(settings->shouldAppsUseDarkMode(), std::optional<bool>(false));
+    // The light wallpaper is in use now.
+    QTRY_COMPARE(wallpaperSpy.count(), 1);
+    QCOMPARE(settings->wallpaperFilePath(), std::optional<QString>(FRAMELESSHELPER_STRING_LITERAL("/tmp/light.png")));
+
+    m_portal.change(kAppearanceGroup, kAccentColorKey, accentColorValue(1.0, 0.0, 0.0));
+    QTRY_COMPARE(accentColorSpy.count(), 1);
+    QCOMPARE(settings->accentColor(), std::optional<QColor>(QColor::fromRgbF(1.0, 0.0, 0.0)));
+
+    m_portal.change(kBackgroundGroup, kPictureOptionsKey, FRAMELESSHELPER_STRING_LITERAL("wallpaper"));
+    QTRY_COMPARE(wallpaperSpy.count(), 2);
+    QCOMPARE(settings->wallpaperAspectStyle(), std::optional<WallpaperAspectStyle>(WallpaperAspectStyle::Tile));
+
+    // Setting the same value again must not emit anything.
+    m_portal.change(kAppearanceGroup, kColorSchemeKey, QVariant::fromValue(quint32(2)));
+    QTest::qWait(200);
+    QCOMPARE(colorSchemeSpy.count(), 1);
+#endif
+}
+
+void tst_XdgPortalSettings::noPreference()
+{
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+    XdgPortalSettings * const settings = XdgPortalSettings::instance();
+    QSignalSpy colorSchemeSpy(settings, &XdgPortalSettings::colorSchemeChanged);
+    m_portal.change(kAppearanceGroup, kColorSchemeKey, QVariant::fromValue(quint32(0)));
+    QTRY_COMPARE(colorSchemeSpy.count(), 1);
+    // The caller has to fall back to something else in this case.
+    QVERIFY(!settings->shouldAppsUseDarkMode().has_value());
+#endif
+}
+
+QTEST_GUILESS_MAIN(tst_XdgPortalSettings)
+
+#include "tst_xdgportalsettings.moc"
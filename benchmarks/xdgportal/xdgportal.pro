@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_xdgportalsettings
+QT += testlib dbus
+CONFIG += testcase
+SOURCES += \
+    tst_xdgportalsettings.cpp
+include(../../qmake/core.pri)
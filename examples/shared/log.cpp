@@ -22,56 +22,260 @@
  * SOFTWARE.
  */
 
+
 #include "log.h"
 #include <QtCore/qdebug.h>
 #include <QtCore/qfile.h>
-#include <QtCore/qtextstream.h>
-#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <framelesshelpercore_global.h>
 
-#ifndef QT_ENDL
-#  if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
-#    define QT_ENDL Qt::endl
-#  else
-#    define QT_ENDL endl
-#  endif
-#endif
+// The message handler only formats the message and pushes it into a bounded
+// lock-free ring buffer, all console and file I/O happens on a background
+// thread which drains the queue in batches and flushes once per batch. This
+// keeps logging from perturbing the latency of the GUI thread.
 
-static QString g_app = {};
-static bool g_logError = false;
+static constexpr const std::size_t kQueueCapacity = 8192; // Must be a power of two.
+static constexpr const std::size_t kMaximumBatchSize = 256;
+static constexpr const auto kIdleWaitTime = std::chrono::milliseconds(50);
 
-static std::unique_ptr<QFile> g_logFile = nullptr;
-static std::unique_ptr<QTextStream> g_logStream = nullptr;
+static_assert((kQueueCapacity & (kQueueCapacity - 1)) == 0, "The queue capacity must be a power of two.");
 
-static inline void myMessageHandler(const QtMsgType type, const QMessageLogContext &context, const QString &message)
+// Deliberately leaked so that it outlives the static destructors, the log file
+// is still written to synchronously once the sink is gone.
+static const QByteArray *g_logFilePath = nullptr;
+static std::mutex g_syncMutex;
+
+class AsyncLogSink
 {
-    if (message.isEmpty()) {
-        return;
+    Q_DISABLE_COPY(AsyncLogSink)
+
+public:
+    explicit AsyncLogSink();
+    ~AsyncLogSink();
+
+    bool push(const QtMsgType type, QByteArray &&text);
+    void stop();
+
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence{0};
+        QtMsgType type = QtDebugMsg;
+        QByteArray text = {};
+    };
+
+    [[nodiscard]] std::size_t drain();
+    void run();
+
+private:
+    std::unique_ptr<Slot[]> m_slots = nullptr;
+    alignas(64) std::atomic<std::size_t> m_enqueuePos{0};
+    alignas(64) std::size_t m_dequeuePos = 0; // Only touched by the worker thread.
+    std::atomic<quint64> m_droppedCount{0};
+    std::atomic<bool> m_workerWaiting{false};
+    std::atomic<bool> m_quit{false};
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_worker;
+    QFile m_file;
+    bool m_fileError = false;
+};
+
+static std::atomic<AsyncLogSink *> g_sink{nullptr};
+
+AsyncLogSink::AsyncLogSink() : m_slots(std::make_unique<Slot[]>(kQueueCapacity))
+{
+    for (std::size_t index = 0; index != kQueueCapacity; ++index) {
+        m_slots[index].sequence.store(index, std::memory_order_relaxed);
+    }
+    m_worker = std::thread([this](){ run(); });
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+    stop();
+}
+
+bool AsyncLogSink::push(const QtMsgType type, QByteArray &&text)
+{
+    // Bounded MPMC queue (Dmitry Vyukov), used here with a single consumer.
+    Slot *slot = nullptr;
+    std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        slot = &m_slots[pos & (kQueueCapacity - 1)];
+        const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The queue is full, drop the message rather than blocking the caller.
+            m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
     }
-    const QString finalMessage = qFormatLogMessage(type, context, message).trimmed();
-    if ((type == QtInfoMsg) || (type == QtDebugMsg)) {
-        std::cout << qUtf8Printable(finalMessage) << std::endl;
-    } else {
-        std::cerr << qUtf8Printable(finalMessage) << std::endl;
+    slot->type = type;
+    slot->text = std::move(text);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    if (m_workerWaiting.load(std::memory_order_acquire)) {
+        m_condition.notify_one();
     }
-    if (g_logError) {
+    return true;
+}
+
+void AsyncLogSink::stop()
+{
+    if (!m_worker.joinable()) {
         return;
     }
-    if (!g_logFile) {
-        g_logFile = std::make_unique<QFile>();
-        g_logFile->setFileName(FRAMELESSHELPER_STRING_LITERAL("debug-%1.log").arg(g_app));
-        if (!g_logFile->open(QFile::WriteOnly | QFile::Text | QFile::Append)) {
-            std::cerr << "Can't open file to write: " << qUtf8Printable(g_logFile->errorString()) << std::endl;
-            g_logFile.reset();
-            g_logError = true;
-            return;
+    {
+        const std::lock_guard<std::mutex> locker(m_mutex);
+        m_quit.store(true, std::memory_order_release);
+    }
+    m_condition.notify_one();
+    m_worker.join();
+}
+
+std::size_t AsyncLogSink::drain()
+{
+    QByteArray out = {};
+    QByteArray err = {};
+    QByteArray all = {}; // Keeps the original order for the log file.
+    std::size_t count = 0;
+    while (count < kMaximumBatchSize) {
+        Slot &slot = m_slots[m_dequeuePos & (kQueueCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != (m_dequeuePos + 1)) {
+            break;
+        }
+        QByteArray &target = (((slot.type == QtInfoMsg) || (slot.type == QtDebugMsg)) ? out : err);
+        target.append(slot.text);
+        target.append('\n');
+        all.append(slot.text);
+        all.append('\n');
+        slot.text.clear();
+        slot.sequence.store(m_dequeuePos + kQueueCapacity, std::memory_order_release);
+        ++m_dequeuePos;
+        ++count;
+    }
+    const quint64 dropped = m_droppedCount.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        const QByteArray note = "[Log] The log queue overflowed, " + QByteArray::number(dropped)
+                                + " message(s) have been dropped.\n";
+        err.append(note);
+        all.append(note);
+    }
+    if (all.isEmpty()) {
+        return 0;
+    }
+    if (!out.isEmpty()) {
+        std::fwrite(out.constData(), 1, std::size_t(out.size()), stdout);
+        std::fflush(stdout);
+    }
+    if (!err.isEmpty()) {
+        std::fwrite(err.constData(), 1, std::size_t(err.size()), stderr);
+        std::fflush(stderr);
+    }
+    if (m_fileError) {
+        return count;
+    }
+    if (!m_file.isOpen()) {
+        m_file.setFileName(QFile::decodeName(*g_logFilePath));
+        if (!m_file.open(QFile::WriteOnly | QFile::Text | QFile::Append)) {
+            std::fprintf(stderr, "Can't open file to write: %s\n", qUtf8Printable(m_file.errorString()));
+            m_fileError = true;
+            return count;
+        }
+    }
+    m_file.write(all);
+    m_file.flush();
+    return count;
+}
+
+void AsyncLogSink::run()
+{
+    while (true) {
+        if (drain() > 0) {
+            continue;
         }
+        if (m_quit.load(std::memory_order_acquire)) {
+            // A producer may still be in the middle of publishing a slot,
+            // the last drain picks up everything that has been completed.
+            while (drain() > 0) {}
+            break;
+        }
+        std::unique_lock<std::mutex> locker(m_mutex);
+        m_workerWaiting.store(true, std::memory_order_release);
+        // The timeout guards against a notification racing with the flag above.
+        m_condition.wait_for(locker, kIdleWaitTime);
+        m_workerWaiting.store(false, std::memory_order_release);
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+static inline void writeSynchronously(const QByteArray &text)
+{
+    const std::lock_guard<std::mutex> locker(g_syncMutex);
+    std::fwrite(text.constData(), 1, std::size_t(text.size()), stderr);
+    std::fputc('\n', stderr);
+    std::fflush(stderr);
+    if (!g_logFilePath) {
+        return;
+    }
+    // Only called after the worker has finished with the file, so appending
+    // here keeps the messages in order.
+    std::FILE * const file = std::fopen(g_logFilePath->constData(), "a");
+    if (!file) {
+        return;
+    }
+    std::fwrite(text.constData(), 1, std::size_t(text.size()), file);
+    std::fputc('\n', file);
+    std::fclose(file);
+}
+
+static void shutdownLogSink()
+{
+    AsyncLogSink * const sink = g_sink.exchange(nullptr, std::memory_order_acq_rel);
+    if (!sink) {
+        return;
+    }
+    // Deliberately leaked: another thread may still hold the pointer it loaded
+    // just before we reset it, anything it pushes now is simply never written.
+    sink->stop();
+}
+
+static inline void myMessageHandler(const QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    if (message.isEmpty()) {
+        return;
+    }
+    // The context is only valid during this call, so the message has to be
+    // formatted on the calling thread.
+    QByteArray finalMessage = qFormatLogMessage(type, context, message).trimmed().toUtf8();
+    if (type == QtFatalMsg) {
+        // The application is going to abort right after we return, so make sure
+        // everything queued so far reaches the disk before the fatal message.
+        shutdownLogSink();
+        writeSynchronously(finalMessage);
+        return;
     }
-    if (!g_logStream) {
-        g_logStream = std::make_unique<QTextStream>();
-        g_logStream->setDevice(g_logFile.get());
+    AsyncLogSink * const sink = g_sink.load(std::memory_order_acquire);
+    if (!sink) {
+        // The sink has already been torn down (late messages during exit).
+        writeSynchronously(finalMessage);
+        return;
     }
-    (*g_logStream) << finalMessage << QT_ENDL;
+    sink->push(type, std::move(finalMessage));
 }
 
 void Log::setup(const QString &app)
@@ -85,7 +289,9 @@ void Log::setup(const QString &app)
         return;
     }
     once = true;
-    g_app = app;
+    g_logFilePath = new QByteArray(QFile::encodeName(FRAMELESSHELPER_STRING_LITERAL("debug-%1.log").arg(app)));
+    g_sink.store(new AsyncLogSink, std::memory_order_release);
+    std::atexit(shutdownLogSink);
     qSetMessagePattern(FRAMELESSHELPER_STRING_LITERAL(
         "[%{time yyyy/MM/dd hh:mm:ss.zzz}] <%{if-info}INFO%{endif}%{if-debug}DEBUG"
         "%{endif}%{if-warning}WARNING%{endif}%{if-critical}CRITICAL%{endif}%{if-fatal}"
@@ -27,6 +27,7 @@
 #include "framelesshelper.config"
 #include <QtCore/qglobal.h>
 #include <QtCore/qmath.h>
+#include <QtCore/qlist.h>
 #include <QtCore/qpoint.h>
 #include <QtCore/qsize.h>
 #include <QtCore/qrect.h>
@@ -427,6 +428,16 @@ enum class Option : quint8
 };
 Q_ENUM_NS(Option)
 
+enum class ConfigValue : quint8
+{
+    SystemSettingChangeLatency, // Duration, in milliseconds.
+    RepaintDelay, // Duration, in milliseconds.
+    MicaBlurRadius, // Integer, in pixels.
+    OverrideTheme, // Enum, a SystemTheme. Unknown follows the system.
+    Last = OverrideTheme
+};
+Q_ENUM_NS(ConfigValue)
+
 enum class SystemTheme : quint8
 {
     Unknown,
@@ -581,6 +592,30 @@ enum class WindowCornerStyle : quint8
 };
 Q_ENUM_NS(WindowCornerStyle)
 
+enum class PerformanceCounter : quint8
+{
+    FilteredEvents,
+    HitTests,
+    WallpaperRegenerations,
+    PaletteRefreshes,
+    ForcedRepaints,
+    X11RoundTrips,
+    WindowPaints,
+    PaintedPixels, // Summed up area of the dirty regions, not a number of events.
+    Last = PaintedPixels
+};
+Q_ENUM_NS(PerformanceCounter)
+
+enum class PerformanceTimer : quint8
+{
+    WallpaperGeneration,
+    RepaintAllChildren,
+    TitleBarHitTest,
+    EventHandling,
+    Last = EventHandling
+};
+Q_ENUM_NS(PerformanceTimer)
+
 struct VersionInfo
 {
     struct {
@@ -645,6 +680,20 @@ struct Dpi
     }
 };
 
+struct StartupPhase
+{
+    const char *name = nullptr;
+    qint64 start = 0; // Nanoseconds, relative to the first recorded phase.
+    qint64 duration = 0; // Nanoseconds.
+};
+
+struct PerformanceTimerStatistics
+{
+    quint64 count = 0;
+    quint64 totalTime = 0; // Nanoseconds.
+    quint64 maximumTime = 0; // Nanoseconds.
+};
+
 } // namespace Global
 
 FRAMELESSHELPER_CORE_API void FramelessHelperCoreInitialize();
@@ -652,6 +701,7 @@ FRAMELESSHELPER_CORE_API void FramelessHelperCoreUninitialize();
 [[nodiscard]] FRAMELESSHELPER_CORE_API Global::VersionInfo FramelessHelperVersion();
 FRAMELESSHELPER_CORE_API void FramelessHelperEnableThemeAware();
 FRAMELESSHELPER_CORE_API void FramelessHelperPrintLogo();
+[[nodiscard]] FRAMELESSHELPER_CORE_API QList<Global::StartupPhase> FramelessHelperStartupTrace();
 
 namespace FramelessHelper::Core
 {
@@ -660,6 +710,7 @@ inline void uninitialize() { FramelessHelperCoreUninitialize(); }
 [[nodiscard]] inline Global::VersionInfo version() { return FramelessHelperVersion(); }
 inline void setApplicationOSThemeAware() { FramelessHelperEnableThemeAware(); }
 inline void outputLogo() { FramelessHelperPrintLogo(); }
+[[nodiscard]] inline QList<Global::StartupPhase> startupTrace() { return FramelessHelperStartupTrace(); }
 } // namespace FramelessHelper::Core
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -668,5 +719,6 @@ FRAMELESSHELPER_END_NAMESPACE
 QT_BEGIN_NAMESPACE
 FRAMELESSHELPER_CORE_API QDebug operator<<(QDebug, const FRAMELESSHELPER_PREPEND_NAMESPACE(Global)::VersionInfo &);
 FRAMELESSHELPER_CORE_API QDebug operator<<(QDebug, const FRAMELESSHELPER_PREPEND_NAMESPACE(Global)::Dpi &);
+FRAMELESSHELPER_CORE_API QDebug operator<<(QDebug, const FRAMELESSHELPER_PREPEND_NAMESPACE(Global)::StartupPhase &);
 QT_END_NAMESPACE
 #endif // QT_NO_DEBUG_STREAM
@@ -34,7 +34,7 @@ class FRAMELESSHELPER_CORE_API FramelessManager : public QObject
 {
     FRAMELESSHELPER_PUBLIC_QT_CLASS(FramelessManager)
     Q_PROPERTY(Global::SystemTheme systemTheme READ systemTheme WRITE setOverrideTheme NOTIFY systemThemeChanged FINAL)
-    Q_PROPERTY(QColor systemAccentColor READ systemAccentColor NOTIFY systemThemeChanged FINAL)
+    Q_PROPERTY(QColor systemAccentColor READ systemAccentColor NOTIFY systemAccentColorChanged FINAL)
     Q_PROPERTY(QString wallpaper READ wallpaper NOTIFY wallpaperChanged FINAL)
     Q_PROPERTY(Global::WallpaperAspectStyle wallpaperAspectStyle READ wallpaperAspectStyle NOTIFY wallpaperChanged FINAL)
 
@@ -46,13 +46,25 @@ public:
     Q_NODISCARD QString wallpaper() const;
     Q_NODISCARD Global::WallpaperAspectStyle wallpaperAspectStyle() const;
 
+    // Only collected when the library was built with FRAMELESSHELPER_ENABLE_PERFORMANCE_COUNTERS,
+    // everything reads as zero otherwise.
+    Q_NODISCARD static bool isPerformanceCountersEnabled();
+    Q_NODISCARD quint64 performanceCounter(const Global::PerformanceCounter counter) const;
+    Q_NODISCARD Global::PerformanceTimerStatistics performanceTimer(const Global::PerformanceTimer timer) const;
+    void resetPerformanceCounters();
+
 public Q_SLOTS:
     Q_NODISCARD bool addWindow(const QObject *window, const WId windowId);
     Q_NODISCARD bool removeWindow(const QObject *window);
     void setOverrideTheme(const Global::SystemTheme theme);
 
 Q_SIGNALS:
+    // Emitted once for any of the changes below, prefer the specific ones if you
+    // are only interested in some of them.
     void systemThemeChanged();
+    void systemColorSchemeChanged();
+    void systemAccentColorChanged();
+    void systemColorizationAreaChanged();
     void wallpaperChanged();
 
 private:
@@ -60,4 +72,21 @@ private:
     ~FramelessManager() override;
 };
 
+// Registering a lot of windows at once (restoring a workspace, for example) is
+// cheaper inside one of these: the bookkeeping tables are reserved up front and
+// the X11 requests of all the windows go out with a single flush at the end.
+// Batches can be nested, only the outermost one flushes. Qt Quick windows attach
+// themselves when their FramelessHelper is created, so keep the batch alive while
+// creating them (loading the QML components, for example).
+class FRAMELESSHELPER_CORE_API FramelessRegistrationBatch
+{
+    FRAMELESSHELPER_CLASS(FramelessRegistrationBatch)
+
+public:
+    explicit FramelessRegistrationBatch(const int windowCount);
+    ~FramelessRegistrationBatch();
+
+    Q_NODISCARD static bool isActive();
+};
+
 FRAMELESSHELPER_END_NAMESPACE
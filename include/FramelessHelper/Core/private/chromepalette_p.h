@@ -26,11 +26,31 @@
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
 #include <optional>
+#include <memory>
 
 #if FRAMELESSHELPER_CONFIG(titlebar)
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
+// The system-derived colors only depend on the global theme, so they are computed
+// once per theme change and shared by all palettes. A table is never modified after
+// its creation, a new one (with a bumped version) replaces it instead.
+struct ChromePaletteSystemColors
+{
+    quint64 version = 0;
+    QColor titleBarActiveBackgroundColor = {};
+    QColor titleBarInactiveBackgroundColor = {};
+    QColor titleBarActiveForegroundColor = {};
+    QColor titleBarInactiveForegroundColor = {};
+    QColor chromeButtonNormalColor = {};
+    QColor chromeButtonHoverColor = {};
+    QColor chromeButtonPressColor = {};
+    QColor closeButtonNormalColor = {};
+    QColor closeButtonHoverColor = {};
+    QColor closeButtonPressColor = {};
+};
+using ChromePaletteSystemColorsPtr = std::shared_ptr<const ChromePaletteSystemColors>;
+
 class ChromePalette;
 class FRAMELESSHELPER_CORE_API ChromePalettePrivate : public QObject
 {
@@ -40,19 +60,15 @@ public:
     explicit ChromePalettePrivate(ChromePalette *q);
     ~ChromePalettePrivate() override;
 
+    static void watchSystemColors();
+    Q_NODISCARD static ChromePaletteSystemColorsPtr currentSystemColors();
+
+    Q_NODISCARD const ChromePaletteSystemColors &colors() const;
+
     Q_SLOT void refresh();
 
-    // System-defined ones:
-    QColor titleBarActiveBackgroundColor_sys = {};
-    QColor titleBarInactiveBackgroundColor_sys = {};
-    QColor titleBarActiveForegroundColor_sys = {};
-    QColor titleBarInactiveForegroundColor_sys = {};
-    QColor chromeButtonNormalColor_sys = {};
-    QColor chromeButtonHoverColor_sys = {};
-    QColor chromeButtonPressColor_sys = {};
-    QColor closeButtonNormalColor_sys = {};
-    QColor closeButtonHoverColor_sys = {};
-    QColor closeButtonPressColor_sys = {};
+    // System-defined ones, calculated on first use:
+    mutable ChromePaletteSystemColorsPtr systemColors = nullptr;
     // User-defined ones:
     std::optional<QColor> titleBarActiveBackgroundColor = std::nullopt;
     std::optional<QColor> titleBarInactiveBackgroundColor = std::nullopt;
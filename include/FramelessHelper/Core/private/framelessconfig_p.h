@@ -25,6 +25,45 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <chrono>
+
+// Options can be pinned at build time through the FRAMELESSHELPER_PIN_OPTION_<Name>
+// CMake cache variables, which define the macros below to 1 (on) or 0 (off). The
+// value of a pinned option is a compile time constant, so that the compiler can
+// drop the code paths it disables. -1 means the option is decided at runtime.
+#ifndef FRAMELESSHELPER_PINNED_OPTION_UseCrossPlatformQtImplementation
+#  define FRAMELESSHELPER_PINNED_OPTION_UseCrossPlatformQtImplementation -1
+#endif
+#ifndef FRAMELESSHELPER_PINNED_OPTION_ForceHideWindowFrameBorder
+#  define FRAMELESSHELPER_PINNED_OPTION_ForceHideWindowFrameBorder -1
+#endif
+#ifndef FRAMELESSHELPER_PINNED_OPTION_ForceShowWindowFrameBorder
+#  define FRAMELESSHELPER_PINNED_OPTION_ForceShowWindowFrameBorder -1
+#endif
+#ifndef FRAMELESSHELPER_PINNED_OPTION_DisableWindowsSnapLayout
+#  define FRAMELESSHELPER_PINNED_OPTION_DisableWindowsSnapLayout -1
+#endif
+#ifndef FRAMELESSHELPER_PINNED_OPTION_WindowUseRoundCorners
+#  define FRAMELESSHELPER_PINNED_OPTION_WindowUseRoundCorners -1
+#endif
+#ifndef FRAMELESSHELPER_PINNED_OPTION_CenterWindowBeforeShow
+#  define FRAMELESSHELPER_PINNED_OPTION_CenterWindowBeforeShow -1
+#endif
+#ifndef FRAMELESSHELPER_PINNED_OPTION_EnableBlurBehindWindow
+#  define FRAMELESSHELPER_PINNED_OPTION_EnableBlurBehindWindow -1
+#endif
+#ifndef FRAMELESSHELPER_PINNED_OPTION_ForceNonNativeBackgroundBlur
+#  define FRAMELESSHELPER_PINNED_OPTION_ForceNonNativeBackgroundBlur -1
+#endif
+#ifndef FRAMELESSHELPER_PINNED_OPTION_DisableLazyInitializationForMicaMaterial
+#  define FRAMELESSHELPER_PINNED_OPTION_DisableLazyInitializationForMicaMaterial -1
+#endif
+#ifndef FRAMELESSHELPER_PINNED_OPTION_ForceNativeBackgroundBlur
+#  define FRAMELESSHELPER_PINNED_OPTION_ForceNativeBackgroundBlur -1
+#endif
+#ifndef FRAMELESSHELPER_PINNED_OPTION_WindowUseSquareCorners
+#  define FRAMELESSHELPER_PINNED_OPTION_WindowUseSquareCorners -1
+#endif
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -37,15 +76,64 @@ public:
 
     void reload(const bool force = false);
 
+    // Returns 1 or 0 for options pinned at build time, -1 otherwise.
+    Q_NODISCARD static constexpr int pinnedState(const Global::Option option)
+    {
+        constexpr const int states[] = {
+            FRAMELESSHELPER_PINNED_OPTION_UseCrossPlatformQtImplementation,
+            FRAMELESSHELPER_PINNED_OPTION_ForceHideWindowFrameBorder,
+            FRAMELESSHELPER_PINNED_OPTION_ForceShowWindowFrameBorder,
+            FRAMELESSHELPER_PINNED_OPTION_DisableWindowsSnapLayout,
+            FRAMELESSHELPER_PINNED_OPTION_WindowUseRoundCorners,
+            FRAMELESSHELPER_PINNED_OPTION_CenterWindowBeforeShow,
+            FRAMELESSHELPER_PINNED_OPTION_EnableBlurBehindWindow,
+            FRAMELESSHELPER_PINNED_OPTION_ForceNonNativeBackgroundBlur,
+            FRAMELESSHELPER_PINNED_OPTION_DisableLazyInitializationForMicaMaterial,
+            FRAMELESSHELPER_PINNED_OPTION_ForceNativeBackgroundBlur,
+            FRAMELESSHELPER_PINNED_OPTION_WindowUseSquareCorners
+        };
+        static_assert(std::size(states) == (static_cast<int>(Global::Option::Last) + 1));
+        return states[static_cast<int>(option)];
+    }
+    Q_NODISCARD static constexpr bool isPinned(const Global::Option option)
+    {
+        return (pinnedState(option) >= 0);
+    }
+
     void set(const Global::Option option, const bool on = true);
-    Q_NODISCARD bool isSet(const Global::Option option) const;
+    Q_NODISCARD bool isSet(const Global::Option option) const
+    {
+        if (isPinned(option)) {
+            return (pinnedState(option) > 0);
+        }
+        return isSetAtRuntime(option);
+    }
+
+    void setValue(const Global::ConfigValue key, const int value);
+    Q_NODISCARD int value(const Global::ConfigValue key) const;
+    Q_NODISCARD std::chrono::milliseconds duration(const Global::ConfigValue key) const;
+    template<typename T>
+    Q_NODISCARD T valueAs(const Global::ConfigValue key) const { return static_cast<T>(value(key)); }
+
+    // Watch the configuration file and reload it whenever it changes, so that
+    // the options can be tuned without restarting the application. Like any forced
+    // reload, this overwrites what has been changed through set() and setValue().
+    // Can also be enabled by setting "FRAMELESSHELPER_CONFIG_AUTO_RELOAD" to 1.
+    void setAutoReloadEnabled(const bool on = true);
+    Q_NODISCARD bool isAutoReloadEnabled() const;
 
     static void setLoadFromEnvironmentVariablesDisabled(const bool on = true);
     static void setLoadFromConfigurationFileDisabled(const bool on = true);
 
+Q_SIGNALS:
+    void optionChanged(const Global::Option option, const bool on);
+    void valueChanged(const Global::ConfigValue key, const int value);
+
 private:
     explicit FramelessConfig(QObject *parent = nullptr);
     ~FramelessConfig() override;
+
+    Q_NODISCARD bool isSetAtRuntime(const Global::Option option) const;
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qmutex.h>
 #include <QtCore/qtimer.h>
 #include <optional>
 
@@ -33,6 +34,19 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 struct FramelessData;
 using FramelessDataPtr = std::shared_ptr<FramelessData>;
 
+// The individual facets of the system settings we are tracking. The platform
+// backends report what has actually changed, so that we only re-read that.
+enum class SystemSettingChange : quint8
+{
+    None = 0,
+    Theme = 1 << 0,
+    AccentColor = 1 << 1,
+    ColorizationArea = 1 << 2, // Windows only.
+    Wallpaper = 1 << 3
+};
+Q_DECLARE_FLAGS(SystemSettingChanges, SystemSettingChange)
+Q_DECLARE_OPERATORS_FOR_FLAGS(SystemSettingChanges)
+
 class FramelessManager;
 class FRAMELESSHELPER_CORE_API FramelessManagerPrivate : public QObject
 {
@@ -43,17 +57,28 @@ public:
     ~FramelessManagerPrivate() override;
 
     static void initializeIconFont();
+    // Whether frameless windows get Qt::FramelessWindowHint, rather than having the
+    // system title bar hidden by some other means. The helpers use it to apply the
+    // hint before the native window is created, changing it later is expensive.
+    Q_NODISCARD static bool shouldApplyFramelessWindowHint();
     Q_NODISCARD static QFont getIconFont();
 
     Q_SLOT void notifySystemThemeHasChangedOrNot();
     Q_SLOT void notifyWallpaperHasChangedOrNot();
+    void notifySystemSettingsChanged(const SystemSettingChanges changes);
 
     Q_NODISCARD bool isThemeOverrided() const;
 
     void initialize();
 
-    void doNotifySystemThemeHasChangedOrNot();
-    void doNotifyWallpaperHasChangedOrNot();
+    // Reading the system settings can be slow (DBus, GSettings, registry, ...) and
+    // most applications don't need all of them before their first window shows up,
+    // so every facet is only queried the first time somebody asks for it. Both must be
+    // called with settingsMutex locked, wallpaper() is also used by the wallpaper thread.
+    void ensureSystemTheme();
+    void ensureWallpaper();
+
+    void refreshSystemSettings(const SystemSettingChanges changes);
 
     Q_NODISCARD static FramelessDataPtr getData(const QObject *window);
     Q_NODISCARD static FramelessDataPtr createData(const QObject *window, const WId windowId);
@@ -69,8 +94,14 @@ public:
 #endif
     QString wallpaper = {};
     Global::WallpaperAspectStyle wallpaperAspectStyle = Global::WallpaperAspectStyle::Fill;
-    QTimer themeTimer{};
-    QTimer wallpaperTimer{};
+    bool systemThemeLoaded = false;
+    bool wallpaperLoaded = false;
+    mutable QMutex settingsMutex;
+    // The notifications are coalesced by one timer: the facets reported in the mean
+    // time are accumulated and re-read together, so that a theme switch which touches
+    // several facets at once still only results in one round of change signals.
+    QTimer changeTimer{};
+    SystemSettingChanges pendingChanges = {};
 };
 
 class InternalEventFilter : public QObject
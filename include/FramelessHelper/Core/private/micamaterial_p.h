@@ -26,6 +26,7 @@
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
 #include <QtGui/qbrush.h>
+#include <QtGui/qimage.h>
 #ifdef FRAMELESSHELPER_HAS_THREAD
 #  undef FRAMELESSHELPER_HAS_THREAD
 #endif
@@ -57,6 +58,10 @@ public:
 
     Q_NODISCARD static QColor systemFallbackColor();
 
+    // The image kernels used to generate the blurred wallpaper, exposed for the benchmarks.
+    Q_NODISCARD static QImage halfScaled(const QImage &image);
+    static void blurImage(QImage &image, const qreal radius, const bool quality = false);
+
     Q_NODISCARD QPoint mapToWallpaper(const QPoint &pos) const;
     Q_NODISCARD QSize mapToWallpaper(const QSize &size) const;
     Q_NODISCARD QRect mapToWallpaper(const QRect &rect) const;
@@ -0,0 +1,78 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+#  include <QtCore/qelapsedtimer.h>
+#endif
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Cheap counters and timers for the hot paths of the library, to find out what it
+// is doing when a window feels janky. They are only compiled in when the library is
+// configured with FRAMELESSHELPER_ENABLE_PERFORMANCE_COUNTERS, otherwise the macros
+// below expand to nothing. Everything is safe to call from any thread.
+class FRAMELESSHELPER_CORE_API PerformanceCounters
+{
+    FRAMELESSHELPER_CLASS(PerformanceCounters)
+
+public:
+    static void increment(const Global::PerformanceCounter counter);
+    static void add(const Global::PerformanceCounter counter, const quint64 value);
+    static void record(const Global::PerformanceTimer timer, const quint64 nsecs);
+
+    Q_NODISCARD static quint64 counter(const Global::PerformanceCounter counter);
+    Q_NODISCARD static Global::PerformanceTimerStatistics timer(const Global::PerformanceTimer timer);
+    static void reset();
+};
+
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+class FRAMELESSHELPER_CORE_API PerformanceTimerScope
+{
+    FRAMELESSHELPER_CLASS(PerformanceTimerScope)
+
+public:
+    explicit PerformanceTimerScope(const Global::PerformanceTimer timer);
+    ~PerformanceTimerScope();
+
+private:
+    Global::PerformanceTimer m_timer = {};
+    QElapsedTimer m_elapsedTimer;
+};
+
+#  define FRAMELESSHELPER_PERFORMANCE_COUNT(Counter) \
+      FRAMELESSHELPER_PREPEND_NAMESPACE(PerformanceCounters)::increment(FRAMELESSHELPER_PREPEND_NAMESPACE(Global)::PerformanceCounter::Counter)
+#  define FRAMELESSHELPER_PERFORMANCE_ADD(Counter, Value) \
+      FRAMELESSHELPER_PREPEND_NAMESPACE(PerformanceCounters)::add(FRAMELESSHELPER_PREPEND_NAMESPACE(Global)::PerformanceCounter::Counter, (Value))
+#  define FRAMELESSHELPER_PERFORMANCE_TIME_SCOPE(Timer) \
+      const FRAMELESSHELPER_PREPEND_NAMESPACE(PerformanceTimerScope) __framelesshelper_performance_timer_scope(FRAMELESSHELPER_PREPEND_NAMESPACE(Global)::PerformanceTimer::Timer)
+#else // !FRAMELESSHELPER_CONFIG(performance_counters)
+#  define FRAMELESSHELPER_PERFORMANCE_COUNT(Counter) static_cast<void>(0)
+#  define FRAMELESSHELPER_PERFORMANCE_ADD(Counter, Value) static_cast<void>(0)
+#  define FRAMELESSHELPER_PERFORMANCE_TIME_SCOPE(Timer) static_cast<void>(0)
+#endif // FRAMELESSHELPER_CONFIG(performance_counters)
+
+FRAMELESSHELPER_END_NAMESPACE
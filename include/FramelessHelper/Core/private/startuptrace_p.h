@@ -0,0 +1,48 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Records how long one step of the library's startup took. The phases end up in
+// FramelessHelperStartupTrace(), and are also printed as soon as they finish if
+// the "FRAMELESSHELPER_STARTUP_TRACE" environment variable is set to a non-zero
+// value. The name must be a string literal, it's stored as is.
+class FRAMELESSHELPER_CORE_API StartupTraceScope
+{
+    FRAMELESSHELPER_CLASS(StartupTraceScope)
+
+public:
+    explicit StartupTraceScope(const char *name);
+    ~StartupTraceScope();
+
+private:
+    const char *m_name = nullptr;
+    qint64 m_start = 0;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -25,6 +25,8 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qstringlist.h>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -33,6 +35,9 @@ class FRAMELESSHELPER_CORE_API SysApiLoader : public QObject
     FRAMELESSHELPER_QT_CLASS(SysApiLoader)
 
 public:
+    // Library name -> function names.
+    using Symbols = QHash<QString, QStringList>;
+
     Q_NODISCARD static SysApiLoader *instance();
 
     Q_NODISCARD static QString platformSharedLibrarySuffixName();
@@ -42,8 +47,26 @@ public:
     Q_NODISCARD static QFunctionPointer resolve(const QString &library, const char *function);
     Q_NODISCARD static QFunctionPointer resolve(const QString &library, const QString &function);
 
+    Q_NODISCARD static constexpr quint64 hashKey(const char *str)
+    {
+        // 64-bit FNV-1a, evaluated at compile time for the API_* macros below.
+        quint64 hash = 14695981039346656037ull;
+        while (str && (*str != '\0')) {
+            hash ^= static_cast<quint64>(static_cast<unsigned char>(*str));
+            hash *= 1099511628211ull;
+            ++str;
+        }
+        return hash;
+    }
+
     Q_NODISCARD bool isAvailable(const QString &library, const QString &function);
 
+    Q_NODISCARD QFunctionPointer getOrResolve(const QString &library, const QString &function);
+
+    Q_NODISCARD static Symbols platformSymbols();
+    void preload(const Symbols &symbols);
+    void preloadPlatformSymbols();
+
     Q_NODISCARD QFunctionPointer get(const QString &library, const QString &function);
 
     template<typename T>
@@ -57,19 +80,43 @@ private:
     ~SysApiLoader() override;
 };
 
+// Each (library, function, type) combination gets its own slot which is resolved
+// exactly once, the following calls are just a plain read of a static function
+// pointer, no string building or hash table lookup is involved anymore.
+template<const quint64 Key, typename T>
+class SysApiSymbol
+{
+public:
+    template<typename Library, typename Function>
+    Q_NODISCARD static T get(const Library &library, const Function &function)
+    {
+        static const auto symbol = reinterpret_cast<T>(SysApiLoader::instance()->getOrResolve(library, function));
+        return symbol;
+    }
+
+    template<typename Library, typename Function>
+    Q_NODISCARD static bool isAvailable(const Library &library, const Function &function)
+    {
+        return (get(library, function) != nullptr);
+    }
+};
+
 FRAMELESSHELPER_END_NAMESPACE
 
+#define API_SYMBOL(lib, name, type) \
+  FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiSymbol)<FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::hashKey(#lib "@" #name), type>
+
 #define API_AVAILABLE(lib, func) \
-  (FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->isAvailable(k##lib, k##func))
+  (API_SYMBOL(lib, func, QFunctionPointer)::isAvailable(k##lib, k##func))
 
 #define API_CALL_FUNCTION(lib, func, ...) \
-  ((FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->get<decltype(&func)>(k##lib, k##func))(__VA_ARGS__))
+  ((API_SYMBOL(lib, func, decltype(&func))::get(k##lib, k##func))(__VA_ARGS__))
 
 #define API_CALL_FUNCTION2(lib, func, type, ...) \
-  ((FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->get<type>(k##lib, k##func))(__VA_ARGS__))
+  ((API_SYMBOL(lib, func, type)::get(k##lib, k##func))(__VA_ARGS__))
 
 #define API_CALL_FUNCTION3(lib, func, name, ...) \
-  ((FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->get<decltype(&func)>(k##lib, k##name))(__VA_ARGS__))
+  ((API_SYMBOL(lib, name, decltype(&func))::get(k##lib, k##name))(__VA_ARGS__))
 
 #define API_CALL_FUNCTION4(lib, func, ...) API_CALL_FUNCTION3(lib, _##func, func, __VA_ARGS__)
 
@@ -26,6 +26,7 @@
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
 #include <optional>
+#include <array>
 
 #if FRAMELESSHELPER_CONFIG(border_painter)
 
@@ -37,13 +38,24 @@ class FRAMELESSHELPER_CORE_API WindowBorderPainterPrivate : public QObject
     FRAMELESSHELPER_PRIVATE_QT_CLASS(WindowBorderPainter)
 
 public:
+    struct PaintCache
+    {
+        QColor color = {};
+        int thickness = 0;
+        Global::WindowEdges edges = {};
+    };
+
     explicit WindowBorderPainterPrivate(WindowBorderPainter *q);
     ~WindowBorderPainterPrivate() override;
 
+    Q_NODISCARD const PaintCache &getPaintCache(const bool active);
+    Q_SLOT void invalidatePaintCache();
+
     std::optional<int> thickness = std::nullopt;
     std::optional<Global::WindowEdges> edges = std::nullopt;
     std::optional<QColor> activeColor = std::nullopt;
     std::optional<QColor> inactiveColor = std::nullopt;
+    std::array<std::optional<PaintCache>, 2> paintCache = {};
 };
 
 FRAMELESSHELPER_END_NAMESPACE
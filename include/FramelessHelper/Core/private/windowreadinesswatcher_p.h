@@ -0,0 +1,69 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QWindow;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Tells when the platform window behind a QWindow is stable enough to have its
+// geometry and attributes changed, so that nothing we do gets overwritten by the
+// QPA plugin finishing its own initialization. This replaces waiting for a fixed
+// amount of time: a window that is not shown yet is ready as soon as the events
+// posted during its creation have been delivered, a window that is being shown by
+// then is ready once it has been exposed for the first time.
+class FRAMELESSHELPER_CORE_API WindowReadinessWatcher : public QObject
+{
+    FRAMELESSHELPER_QT_CLASS(WindowReadinessWatcher)
+
+public:
+    using Callback = std::function<void()>;
+
+    // The callback is invoked exactly once, unless "context" is destroyed before that.
+    static void watch(QWindow *window, QObject *context, const Callback &callback);
+
+protected:
+    Q_NODISCARD bool eventFilter(QObject *object, QEvent *event) override;
+
+private:
+    explicit WindowReadinessWatcher(QWindow *window, const Callback &callback, QObject *parent = nullptr);
+    ~WindowReadinessWatcher() override;
+
+    void check();
+    void finish();
+
+private:
+    QPointer<QWindow> m_window;
+    Callback m_callback = nullptr;
+    bool m_waitingForExpose = false;
+    bool m_finished = false;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qset.h>
+#include <QtGui/qcolor.h>
+#include <optional>
+
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+
+#include <QtDBus/qdbusextratypes.h>
+
+QT_BEGIN_NAMESPACE
+class QDBusPendingCallWatcher;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Reads the desktop appearance settings from the "org.freedesktop.portal.Settings"
+// interface of the XDG desktop portal, which is available on both GNOME and KDE
+// without pulling in any toolkit libraries. Everything is fetched with one ReadAll
+// call and kept up to date through the SettingChanged signal. Nothing ever blocks on
+// the bus: until the ReadAll reply has arrived the portal is reported as unavailable
+// and all getters return std::nullopt, settingsLoaded() is emitted once the call has
+// finished, whether it succeeded or not.
+// The portal is looked up on the session bus, so pointing DBUS_SESSION_BUS_ADDRESS
+// to a private bus with a fake portal service is enough to exercise this class.
+class FRAMELESSHELPER_CORE_API XdgPortalSettings : public QObject
+{
+    FRAMELESSHELPER_QT_CLASS(XdgPortalSettings)
+
+public:
+    // Returns nullptr if there is no Q(Gui)Application instance (yet or anymore).
+    Q_NODISCARD static XdgPortalSettings *instance();
+
+    Q_NODISCARD bool isAvailable() const;
+    // Whether the initial ReadAll call is still in flight, the portal may still answer.
+    Q_NODISCARD bool isPending() const;
+
+    // std::nullopt means the portal doesn't know, the caller should fall back to something else.
+    Q_NODISCARD std::optional<bool> shouldAppsUseDarkMode() const;
+    Q_NODISCARD std::optional<QColor> accentColor() const;
+    Q_NODISCARD std::optional<QString> wallpaperFilePath() const;
+    Q_NODISCARD std::optional<Global::WallpaperAspectStyle> wallpaperAspectStyle() const;
+
+Q_SIGNALS:
+    void settingsLoaded();
+    void colorSchemeChanged();
+    void accentColorChanged();
+    void wallpaperChanged();
+
+private Q_SLOTS:
+    void onSettingChanged(const QString &group, const QString &key, const QDBusVariant &value);
+    void onReadAllFinished(QDBusPendingCallWatcher *watcher);
+
+private:
+    explicit XdgPortalSettings(QObject *parent = nullptr);
+    ~XdgPortalSettings() override;
+
+    static void destroyInstance();
+    void connectToPortal();
+    Q_NODISCARD bool updateSetting(const QString &group, const QString &key, const QVariant &value);
+
+private:
+    struct Settings
+    {
+        std::optional<quint32> colorScheme = std::nullopt;
+        std::optional<QColor> accentColor = std::nullopt;
+        QString pictureUri = {};
+        QString pictureUriDark = {};
+        QString pictureOptions = {};
+    };
+    // The getters are also used by the wallpaper thread.
+    mutable QMutex m_mutex;
+    bool m_available = false;
+    bool m_pending = true;
+    bool m_loaded = false;
+    // Settings changed before the initial snapshot arrived, the snapshot must not override them.
+    QSet<QString> m_changedBeforeLoaded = {};
+    Settings m_settings = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif // FRAMELESSHELPER_CONFIG(xdg_portal)
@@ -28,6 +28,7 @@
 #include <QtQuick/qquickitem.h>
 #include <QtQuick/qquickwindow.h>
 #include <memory>
+#include <functional>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -74,7 +75,11 @@ public:
 #endif
 
     Q_NODISCARD bool isReady() const;
+    // Prefer callWhenReady(), this one spins a nested event loop until the window is ready.
     void waitForReady();
+    // Runs the callback as soon as the window is ready (right away if it already is),
+    // unless "context" (or this helper, if it's null) is destroyed before that.
+    void callWhenReady(QObject *context, const std::function<void()> &callback);
 
 public Q_SLOTS:
     void extendsContentIntoTitleBar(const bool value = true);
@@ -52,6 +52,7 @@ public:
 
     void attach();
     void detach();
+    void markReady();
 
     void emitSignalForAllInstances(const char *signal);
 
@@ -26,11 +26,16 @@
 
 #include <FramelessHelper/Quick/framelesshelperquick_global.h>
 #include <QtCore/qvariant.h>
-#include <QtQuick/qquickpainteditem.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qicon.h>
+#include <QtQuick/qquickitem.h>
+#include <memory>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
-class FRAMELESSHELPER_QUICK_API QuickImageItem : public QQuickPaintedItem
+struct QuickImageItemLoadGuard;
+
+class FRAMELESSHELPER_QUICK_API QuickImageItem : public QQuickItem
 {
     FRAMELESSHELPER_QT_CLASS(QuickImageItem)
 #ifdef QML_NAMED_ELEMENT
@@ -43,8 +48,6 @@ public:
     explicit QuickImageItem(QQuickItem *parent = nullptr);
     ~QuickImageItem() override;
 
-    void paint(QPainter *painter) override;
-
     Q_NODISCARD QVariant source() const;
     void setSource(const QVariant &value);
 
@@ -52,19 +55,31 @@ Q_SIGNALS:
     void sourceChanged();
 
 protected:
+    QSGNode *updatePaintNode(QSGNode *old, UpdatePaintNodeData *data) override;
+    void updatePolish() override;
+    void itemChange(const ItemChange change, const ItemChangeData &value) override;
     void classBegin() override;
     void componentComplete() override;
 
 private:
-    void fromUrl(const QUrl &value, QPainter *painter) const;
-    void fromString(const QString &value, QPainter *painter) const;
-    void fromImage(const QImage &value, QPainter *painter) const;
-    void fromPixmap(const QPixmap &value, QPainter *painter) const;
-    void fromIcon(const QIcon &value, QPainter *painter) const;
+    void loadSource();
+    void loadFile(const QString &filePath);
+    Q_INVOKABLE void handleImageLoaded(const QImage &image, const int loadId);
+    void invalidateScaledImage();
     Q_NODISCARD QRectF paintArea() const;
 
 private:
     QVariant m_source = {};
+    // The decoded source. Only one of them is valid at a time.
+    QImage m_image = {};
+    QIcon m_icon = {};
+    int m_loadId = 0;
+    std::shared_ptr<QuickImageItemLoadGuard> m_loadGuard = nullptr;
+    // The source rasterized at the current item size and device pixel ratio.
+    QImage m_scaledImage = {};
+    bool m_scaledImageDirty = true;
+    quint64 m_scaledImageVersion = 0;
+    quint64 m_textureVersion = 0;
 };
 
 FRAMELESSHELPER_END_NAMESPACE
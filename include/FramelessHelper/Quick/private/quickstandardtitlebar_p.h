@@ -120,7 +120,18 @@ Q_SIGNALS:
     void windowIconChanged();
 
 private:
+    struct WindowIconState
+    {
+        QVariant source = {};
+        QSizeF size = kDefaultWindowIconSize;
+        bool visible = false;
+    };
+
     void initialize();
+    void ensureWindowIcon();
+    void ensureSystemButtons();
+    void registerSystemButtons();
+    void updateTitleLabelAnchors();
     void updateAll();
     Q_NODISCARD bool mouseEventHandler(QMouseEvent *event);
     Q_NODISCARD QRect windowIconRect() const;
@@ -144,6 +155,8 @@ private:
     bool m_hideWhenClose = false;
     QuickChromePalette *m_chromePalette = nullptr;
     bool m_closeTriggered = false;
+    // Holds the window icon properties until the icon item is actually needed.
+    WindowIconState m_windowIconState = {};
 };
 
 FRAMELESSHELPER_END_NAMESPACE
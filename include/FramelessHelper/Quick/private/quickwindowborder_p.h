@@ -25,6 +25,7 @@
 #pragma once
 
 #include <FramelessHelper/Quick/framelesshelperquick_global.h>
+#include <FramelessHelper/Core/private/windowborderpainter_p.h>
 
 #if FRAMELESSHELPER_CONFIG(border_painter)
 
@@ -47,6 +48,8 @@ public:
     void rebindWindow();
 
     WindowBorderPainter *borderPainter = nullptr;
+    // Filled in updatePolish() on the GUI thread, only read by updatePaintNode().
+    WindowBorderPainterPrivate::PaintCache paintCache = {};
     QMetaObject::Connection activeChangeConnection = {};
     QMetaObject::Connection visibilityChangeConnection = {};
 };
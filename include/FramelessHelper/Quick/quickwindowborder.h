@@ -25,7 +25,7 @@
 #pragma once
 
 #include <FramelessHelper/Quick/framelesshelperquick_global.h>
-#include <QtQuick/qquickpainteditem.h>
+#include <QtQuick/qquickitem.h>
 #include <memory>
 
 #if FRAMELESSHELPER_CONFIG(border_painter)
@@ -33,7 +33,7 @@
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
 class QuickWindowBorderPrivate;
-class FRAMELESSHELPER_QUICK_API QuickWindowBorder : public QQuickPaintedItem
+class FRAMELESSHELPER_QUICK_API QuickWindowBorder : public QQuickItem
 {
     FRAMELESSHELPER_PUBLIC_QT_CLASS(QuickWindowBorder)
 #ifdef QML_NAMED_ELEMENT
@@ -54,8 +54,6 @@ public:
     explicit QuickWindowBorder(QQuickItem *parent = nullptr);
     ~QuickWindowBorder() override;
 
-    void paint(QPainter *painter) override;
-
     Q_NODISCARD qreal thickness() const;
     Q_NODISCARD QuickGlobal::WindowEdges edges() const;
     Q_NODISCARD QColor activeColor() const;
@@ -73,6 +71,8 @@ public Q_SLOTS:
     void setInactiveColor(const QColor &value);
 
 protected:
+    QSGNode *updatePaintNode(QSGNode *old, UpdatePaintNodeData *data) override;
+    void updatePolish() override;
     void itemChange(const ItemChange change, const ItemChangeData &value) override;
     void classBegin() override;
     void componentComplete() override;
@@ -27,6 +27,7 @@
 #include <FramelessHelper/Widgets/framelesshelperwidgets_global.h>
 #include <QtWidgets/qwidget.h>
 #include <memory>
+#include <functional>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -52,6 +53,9 @@ public:
     ~FramelessWidgetsHelper() override;
 
     Q_NODISCARD static FramelessWidgetsHelper *get(QObject *object);
+    // Same as calling extendsContentIntoTitleBar() on the helper of each object, but
+    // cheaper when there are many windows, e.g. when restoring a whole workspace.
+    static void extendsContentIntoTitleBar(const QObjectList &objects, const bool value = true);
 
     Q_NODISCARD QWidget *titleBarWidget() const;
     Q_NODISCARD bool isWindowFixedSize() const;
@@ -67,7 +71,11 @@ public:
 #endif
 
     Q_NODISCARD bool isReady() const;
+    // Prefer callWhenReady(), this one spins a nested event loop until the window is ready.
     void waitForReady();
+    // Runs the callback as soon as the window is ready (right away if it already is),
+    // unless "context" (or this helper, if it's null) is destroyed before that.
+    void callWhenReady(QObject *context, const std::function<void()> &callback);
 
 public Q_SLOTS:
     void extendsContentIntoTitleBar(const bool value = true);
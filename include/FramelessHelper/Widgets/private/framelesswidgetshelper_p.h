@@ -50,6 +50,7 @@ public:
 
     void attach();
     void detach();
+    void markReady();
 
     void emitSignalForAllInstances(const char *signal);
 
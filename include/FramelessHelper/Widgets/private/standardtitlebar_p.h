@@ -26,6 +26,8 @@
 
 #include <FramelessHelper/Widgets/framelesshelperwidgets_global.h>
 #include <QtGui/qfont.h>
+#include <QtGui/qpixmap.h>
+#include <QtGui/qstatictext.h>
 #include <optional>
 
 QT_BEGIN_NAMESPACE
@@ -54,6 +56,22 @@ public:
         int ascent = 0;
     };
 
+    struct TitleLabelCache
+    {
+        QStaticText text = {};
+        QPoint position = {};
+        QFont font = {};
+        QSize titleBarSize = {};
+    };
+
+    struct WindowIconCache
+    {
+        QPixmap pixmap = {};
+        QPoint position = {};
+        QSize titleBarSize = {};
+        qreal devicePixelRatio = 1;
+    };
+
     explicit StandardTitleBarPrivate(StandardTitleBar *q);
     ~StandardTitleBarPrivate() override;
 
@@ -65,6 +83,10 @@ public:
     Q_NODISCARD FontMetrics titleLabelSize() const;
     Q_NODISCARD int titleLabelMaxWidth() const;
 
+    Q_NODISCARD const TitleLabelCache &titleLabelCache();
+    Q_NODISCARD const WindowIconCache &windowIconCache();
+    void invalidateCache();
+
     Q_SLOT void updateMaximizeButton();
     Q_SLOT void updateTitleBarColor();
     Q_SLOT void updateChromeButtonColor();
@@ -72,6 +94,8 @@ public:
 
     Q_NODISCARD bool mouseEventHandler(QMouseEvent *event);
 
+    void ensureSystemButtons();
+    void registerSystemButtons();
     void initialize();
 
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
@@ -89,6 +113,8 @@ public:
     bool windowIconVisible = false;
     std::optional<QFont> titleFont = std::nullopt;
     bool closeTriggered = false;
+    std::optional<TitleLabelCache> cachedTitleLabel = std::nullopt;
+    std::optional<WindowIconCache> cachedWindowIcon = std::nullopt;
 
 protected:
     bool eventFilter(QObject *object, QEvent *event) override;
@@ -26,6 +26,7 @@
 
 #include <FramelessHelper/Widgets/framelesshelperwidgets_global.h>
 #include <QtGui/qscreen.h>
+#include <QtGui/qregion.h>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -66,11 +67,16 @@ private Q_SLOTS:
     void handleScreenChanged(QScreen *screen);
 
 private:
+    void invalidate(const QRegion &region);
 #if FRAMELESSHELPER_CONFIG(mica_material)
+    Q_NODISCARD QRegion micaRegion() const;
+    void invalidateMica();
     void repaintMica();
 #endif
 #if FRAMELESSHELPER_CONFIG(border_painter)
-    void repaintBorder();
+    Q_NODISCARD QRegion borderRegion() const;
+    void invalidateBorder();
+    void repaintBorder(const QRegion &dirtyRegion);
 #endif
     void emitCustomWindowStateSignals();
 
@@ -93,6 +99,7 @@ private:
 #if FRAMELESSHELPER_CONFIG(border_painter)
     WindowBorderPainter *m_borderPainter = nullptr;
     QMetaObject::Connection m_borderRepaintConnection = {};
+    QRegion m_borderRegion = {};
 #endif
 };
 
@@ -39,7 +39,10 @@ HEADERS += \
     $$CORE_PRIV_INC_DIR/windowborderpainter_p.h \
     $$CORE_PRIV_INC_DIR/framelesshelpercore_global_p.h \
     $$CORE_PRIV_INC_DIR/versionnumber_p.h \
-    $$CORE_PRIV_INC_DIR/scopeguard_p.h
+    $$CORE_PRIV_INC_DIR/scopeguard_p.h \
+    $$CORE_PRIV_INC_DIR/windowreadinesswatcher_p.h \
+    $$CORE_PRIV_INC_DIR/startuptrace_p.h \
+    $$CORE_PRIV_INC_DIR/performancecounters_p.h
 
 SOURCES += \
     $$CORE_SRC_DIR/chromepalette.cpp \
@@ -50,7 +53,10 @@ SOURCES += \
     $$CORE_SRC_DIR/micamaterial.cpp \
     $$CORE_SRC_DIR/sysapiloader.cpp \
     $$CORE_SRC_DIR/utils.cpp \
-    $$CORE_SRC_DIR/windowborderpainter.cpp
+    $$CORE_SRC_DIR/windowborderpainter.cpp \
+    $$CORE_SRC_DIR/windowreadinesswatcher.cpp \
+    $$CORE_SRC_DIR/startuptrace.cpp \
+    $$CORE_SRC_DIR/performancecounters.cpp
 
 RESOURCES += \
     $$CORE_SRC_DIR/framelesshelpercore.qrc
@@ -74,11 +80,19 @@ unix:!macx {
     CONFIG += link_pkgconfig
     PKGCONFIG += xcb gtk+-3.0
     DEFINES += GDK_VERSION_MIN_REQUIRED=GDK_VERSION_3_6
-    HEADERS += \
-        $$CORE_PUB_INC_DIR/framelesshelper_linux.h
+    HEADERS += $$CORE_PUB_INC_DIR/framelesshelper_linux.h
     SOURCES += \
         $$CORE_SRC_DIR/utils_linux.cpp \
         $$CORE_SRC_DIR/platformsupport_linux.cpp
+    # Same as the CMake build: the XDG desktop portal support needs QtDBus.
+    qtHaveModule(dbus) {
+        QT += dbus
+        HEADERS += $$CORE_PRIV_INC_DIR/xdgportalsettings_p.h
+        SOURCES += $$CORE_SRC_DIR/xdgportalsettings.cpp
+    } else {
+        message("Can't find the QtDBus module. The XDG desktop portal support will be disabled.")
+        DEFINES += FRAMELESSHELPER_NO_XDG_PORTAL
+    }
 }
 
 macx {
@@ -29,6 +29,7 @@
 
 #include "framelessmanager.h"
 #include "utils.h"
+#include "performancecounters_p.h"
 #include <QtCore/qloggingcategory.h>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
@@ -48,6 +49,49 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+struct ChromePaletteData
+{
+    ChromePaletteSystemColorsPtr systemColors = nullptr;
+    quint64 version = 0;
+    bool connected = false;
+};
+
+Q_GLOBAL_STATIC(ChromePaletteData, g_chromePaletteData)
+
+[[nodiscard]] static inline ChromePaletteSystemColorsPtr calculateSystemColors(const quint64 version)
+{
+    const bool colorized = Utils::isTitleBarColorized();
+    const bool dark = (FramelessManager::instance()->systemTheme() == SystemTheme::Dark);
+    auto colors = std::make_shared<ChromePaletteSystemColors>();
+    colors->version = version;
+    colors->titleBarActiveBackgroundColor = [colorized, dark]() -> QColor {
+        if (colorized) {
+            return Utils::getAccentColor();
+        } else {
+            return (dark ? kDefaultBlackColor : kDefaultWhiteColor);
+        }
+    }();
+    colors->titleBarInactiveBackgroundColor = (dark ? kDefaultSystemDarkColor : kDefaultWhiteColor);
+    colors->titleBarActiveForegroundColor = [&colors, dark, colorized]() -> QColor {
+        if (dark || colorized) {
+            return Utils::calculateForegroundColor(colors->titleBarActiveBackgroundColor);
+        }
+        return kDefaultBlackColor;
+    }();
+    colors->titleBarInactiveForegroundColor = kDefaultDarkGrayColor;
+    colors->chromeButtonNormalColor = kDefaultTransparentColor;
+    colors->chromeButtonHoverColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Hovered);
+    colors->chromeButtonPressColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Pressed);
+    colors->closeButtonNormalColor = kDefaultTransparentColor;
+    colors->closeButtonHoverColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Hovered);
+    colors->closeButtonPressColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Pressed);
+    return colors;
+}
+
 ChromePalettePrivate::ChromePalettePrivate(ChromePalette *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -55,8 +99,15 @@ ChromePalettePrivate::ChromePalettePrivate(ChromePalette *q) : QObject(q)
         return;
     }
     q_ptr = q;
-    connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged, this, &ChromePalettePrivate::refresh);
-    refresh();
+    // Must be called before connecting to the signals below, see watchSystemColors().
+    // The colors themselves are only calculated when they are read for the first time:
+    // title bars are usually created while the application starts, but they won't be
+    // painted until their windows are shown.
+    watchSystemColors();
+    FramelessManager * const manager = FramelessManager::instance();
+    connect(manager, &FramelessManager::systemColorSchemeChanged, this, &ChromePalettePrivate::refresh);
+    connect(manager, &FramelessManager::systemAccentColorChanged, this, &ChromePalettePrivate::refresh);
+    connect(manager, &FramelessManager::systemColorizationAreaChanged, this, &ChromePalettePrivate::refresh);
 }
 
 ChromePalettePrivate::~ChromePalettePrivate() = default;
@@ -79,48 +130,93 @@ const ChromePalettePrivate *ChromePalettePrivate::get(const ChromePalette *q)
     return q->d_func();
 }
 
+void ChromePalettePrivate::watchSystemColors()
+{
+    ChromePaletteData * const data = g_chromePaletteData();
+    if (!data->connected) {
+        data->connected = true;
+        // Qt invokes the slots in the order they were connected, and this happens before
+        // any palette connects to the same signals, so the table is always invalidated
+        // first and then re-calculated only once, by the first palette that refreshes.
+        FramelessManager * const manager = FramelessManager::instance();
+        const auto invalidate = [](){ g_chromePaletteData()->systemColors = nullptr; };
+        connect(manager, &FramelessManager::systemColorSchemeChanged, manager, invalidate);
+        connect(manager, &FramelessManager::systemAccentColorChanged, manager, invalidate);
+        connect(manager, &FramelessManager::systemColorizationAreaChanged, manager, invalidate);
+    }
+}
+
+ChromePaletteSystemColorsPtr ChromePalettePrivate::currentSystemColors()
+{
+    watchSystemColors();
+    ChromePaletteData * const data = g_chromePaletteData();
+    if (!data->systemColors) {
+        data->systemColors = calculateSystemColors(++data->version);
+    }
+    return data->systemColors;
+}
+
+const ChromePaletteSystemColors &ChromePalettePrivate::colors() const
+{
+    if (!systemColors) {
+        systemColors = currentSystemColors();
+    }
+    return *systemColors;
+}
+
 void ChromePalettePrivate::refresh()
 {
-    const bool colorized = Utils::isTitleBarColorized();
-    const bool dark = (FramelessManager::instance()->systemTheme() == SystemTheme::Dark);
-    titleBarActiveBackgroundColor_sys = [colorized, dark]() -> QColor {
-        if (colorized) {
-            return Utils::getAccentColor();
-        } else {
-            return (dark ? kDefaultBlackColor : kDefaultWhiteColor);
-        }
-    }();
-    titleBarInactiveBackgroundColor_sys = (dark ? kDefaultSystemDarkColor : kDefaultWhiteColor);
-    titleBarActiveForegroundColor_sys = [this, dark, colorized]() -> QColor {
-        if (dark || colorized) {
-            return Utils::calculateForegroundColor(titleBarActiveBackgroundColor_sys);
-        }
-        return kDefaultBlackColor;
-    }();
-    titleBarInactiveForegroundColor_sys = kDefaultDarkGrayColor;
-    chromeButtonNormalColor_sys = kDefaultTransparentColor;
-    chromeButtonHoverColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Hovered);
-    chromeButtonPressColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Pressed);
-    closeButtonNormalColor_sys = kDefaultTransparentColor;
-    closeButtonHoverColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Hovered);
-    closeButtonPressColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Pressed);
+    // Nobody has seen any of our colors yet, so none of them can be outdated.
+    if (!systemColors) {
+        return;
+    }
+    FRAMELESSHELPER_PERFORMANCE_COUNT(PaletteRefreshes);
+    const ChromePaletteSystemColorsPtr oldColors = systemColors;
+    const ChromePaletteSystemColorsPtr newColors = currentSystemColors();
+    if (oldColors == newColors) {
+        return;
+    }
+    systemColors = newColors;
     Q_Q(ChromePalette);
-    Q_EMIT q->titleBarActiveBackgroundColorChanged();
-    Q_EMIT q->titleBarInactiveBackgroundColorChanged();
-    Q_EMIT q->titleBarActiveForegroundColorChanged();
-    Q_EMIT q->titleBarInactiveForegroundColorChanged();
-    Q_EMIT q->chromeButtonNormalColorChanged();
-    Q_EMIT q->chromeButtonHoverColorChanged();
-    Q_EMIT q->chromeButtonPressColorChanged();
-    Q_EMIT q->closeButtonNormalColorChanged();
-    Q_EMIT q->closeButtonHoverColorChanged();
-    Q_EMIT q->closeButtonPressColorChanged();
-    Q_EMIT q->titleBarColorChanged();
-    Q_EMIT q->chromeButtonColorChanged();
+    bool titleBarColorChanged = false;
+    bool chromeButtonColorChanged = false;
+    // Only notify about the colors that have actually changed, and skip the ones
+    // that are hidden by the user-defined colors, otherwise every single title bar
+    // and system button will be repainted for nothing.
+    const auto update = [q, &oldColors, &newColors](QColor ChromePaletteSystemColors::*color, const std::optional<QColor> &userColor,
+                            void (ChromePalette::*signal)(), bool &groupChanged) -> void {
+        if (userColor.has_value() || (oldColors && ((*oldColors).*color == (*newColors).*color))) {
+            return;
+        }
+        Q_EMIT (q->*signal)();
+        groupChanged = true;
+    };
+    update(&ChromePaletteSystemColors::titleBarActiveBackgroundColor, titleBarActiveBackgroundColor,
+        &ChromePalette::titleBarActiveBackgroundColorChanged, titleBarColorChanged);
+    update(&ChromePaletteSystemColors::titleBarInactiveBackgroundColor, titleBarInactiveBackgroundColor,
+        &ChromePalette::titleBarInactiveBackgroundColorChanged, titleBarColorChanged);
+    update(&ChromePaletteSystemColors::titleBarActiveForegroundColor, titleBarActiveForegroundColor,
+        &ChromePalette::titleBarActiveForegroundColorChanged, titleBarColorChanged);
+    update(&ChromePaletteSystemColors::titleBarInactiveForegroundColor, titleBarInactiveForegroundColor,
+        &ChromePalette::titleBarInactiveForegroundColorChanged, titleBarColorChanged);
+    update(&ChromePaletteSystemColors::chromeButtonNormalColor, chromeButtonNormalColor,
+        &ChromePalette::chromeButtonNormalColorChanged, chromeButtonColorChanged);
+    update(&ChromePaletteSystemColors::chromeButtonHoverColor, chromeButtonHoverColor,
+        &ChromePalette::chromeButtonHoverColorChanged, chromeButtonColorChanged);
+    update(&ChromePaletteSystemColors::chromeButtonPressColor, chromeButtonPressColor,
+        &ChromePalette::chromeButtonPressColorChanged, chromeButtonColorChanged);
+    update(&ChromePaletteSystemColors::closeButtonNormalColor, closeButtonNormalColor,
+        &ChromePalette::closeButtonNormalColorChanged, chromeButtonColorChanged);
+    update(&ChromePaletteSystemColors::closeButtonHoverColor, closeButtonHoverColor,
+        &ChromePalette::closeButtonHoverColorChanged, chromeButtonColorChanged);
+    update(&ChromePaletteSystemColors::closeButtonPressColor, closeButtonPressColor,
+        &ChromePalette::closeButtonPressColorChanged, chromeButtonColorChanged);
+    if (titleBarColorChanged) {
+        Q_EMIT q->titleBarColorChanged();
+    }
+    if (chromeButtonColorChanged) {
+        Q_EMIT q->chromeButtonColorChanged();
+    }
 }
 
 ChromePalette::ChromePalette(QObject *parent) :
@@ -133,61 +229,61 @@ ChromePalette::~ChromePalette() = default;
 QColor ChromePalette::titleBarActiveBackgroundColor() const
 {
     Q_D(const ChromePalette);
-    return d->titleBarActiveBackgroundColor.value_or(d->titleBarActiveBackgroundColor_sys);
+    return d->titleBarActiveBackgroundColor.value_or(d->colors().titleBarActiveBackgroundColor);
 }
 
 QColor ChromePalette::titleBarInactiveBackgroundColor() const
 {
     Q_D(const ChromePalette);
-    return d->titleBarInactiveBackgroundColor.value_or(d->titleBarInactiveBackgroundColor_sys);
+    return d->titleBarInactiveBackgroundColor.value_or(d->colors().titleBarInactiveBackgroundColor);
 }
 
 QColor ChromePalette::titleBarActiveForegroundColor() const
 {
     Q_D(const ChromePalette);
-    return d->titleBarActiveForegroundColor.value_or(d->titleBarActiveForegroundColor_sys);
+    return d->titleBarActiveForegroundColor.value_or(d->colors().titleBarActiveForegroundColor);
 }
 
 QColor ChromePalette::titleBarInactiveForegroundColor() const
 {
     Q_D(const ChromePalette);
-    return d->titleBarInactiveForegroundColor.value_or(d->titleBarInactiveForegroundColor_sys);
+    return d->titleBarInactiveForegroundColor.value_or(d->colors().titleBarInactiveForegroundColor);
 }
 
 QColor ChromePalette::chromeButtonNormalColor() const
 {
     Q_D(const ChromePalette);
-    return d->chromeButtonNormalColor.value_or(d->chromeButtonNormalColor_sys);
+    return d->chromeButtonNormalColor.value_or(d->colors().chromeButtonNormalColor);
 }
 
 QColor ChromePalette::chromeButtonHoverColor() const
 {
     Q_D(const ChromePalette);
-    return d->chromeButtonHoverColor.value_or(d->chromeButtonHoverColor_sys);
+    return d->chromeButtonHoverColor.value_or(d->colors().chromeButtonHoverColor);
 }
 
 QColor ChromePalette::chromeButtonPressColor() const
 {
     Q_D(const ChromePalette);
-    return d->chromeButtonPressColor.value_or(d->chromeButtonPressColor_sys);
+    return d->chromeButtonPressColor.value_or(d->colors().chromeButtonPressColor);
 }
 
 QColor ChromePalette::closeButtonNormalColor() const
 {
     Q_D(const ChromePalette);
-    return d->closeButtonNormalColor.value_or(d->closeButtonNormalColor_sys);
+    return d->closeButtonNormalColor.value_or(d->colors().closeButtonNormalColor);
 }
 
 QColor ChromePalette::closeButtonHoverColor() const
 {
     Q_D(const ChromePalette);
-    return d->closeButtonHoverColor.value_or(d->closeButtonHoverColor_sys);
+    return d->closeButtonHoverColor.value_or(d->colors().closeButtonHoverColor);
 }
 
 QColor ChromePalette::closeButtonPressColor() const
 {
     Q_D(const ChromePalette);
-    return d->closeButtonPressColor.value_or(d->closeButtonPressColor_sys);
+    return d->closeButtonPressColor.value_or(d->colors().closeButtonPressColor);
 }
 
 void ChromePalette::setTitleBarActiveBackgroundColor(const QColor &value)
@@ -23,11 +23,19 @@
  */
 
 #include "framelessconfig_p.h"
+#include "startuptrace_p.h"
 #include <array>
+#include <atomic>
 #include <memory>
+#include <optional>
+#include <algorithm>
 #include <QtCore/qdir.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qfilesystemwatcher.h>
 #include <QtCore/qsettings.h>
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qthread.h>
 #include <QtCore/qtimer.h>
 #include <QtCore/qloggingcategory.h>
 
@@ -48,6 +56,10 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+// Editors usually save a file in several steps (truncate, write, rename, ...),
+// wait for them to finish before reading it again.
+static constexpr const int kAutoReloadDelay = 200; // ms
+
 struct FramelessConfigEntry
 {
     const char *env = nullptr;
@@ -71,16 +83,115 @@ static constexpr const std::array<FramelessConfigEntry, static_cast<int>(Option:
 
 static constexpr const auto OptionCount = std::size(FramelessOptionsTable);
 
+// All options live in one word, so that reading one of them is a single atomic load.
+static_assert(OptionCount <= 32);
+
+enum class FramelessConfigValueType : quint8
+{
+    Integer,
+    Duration, // Milliseconds, the "ms" and "s" suffixes are accepted as well.
+    Enum // The name of an enumerator (case insensitive), or its numeric value.
+};
+
+struct FramelessConfigValueEntry
+{
+    const char *env = nullptr;
+    const char *cfg = nullptr;
+    FramelessConfigValueType type = FramelessConfigValueType::Integer;
+    int defaultValue = 0;
+    int minimumValue = 0;
+    int maximumValue = 0;
+    QMetaEnum (*metaEnum)() = nullptr; // Enum values only.
+};
+
+static constexpr const std::array<FramelessConfigValueEntry, static_cast<int>(ConfigValue::Last) + 1> FramelessValuesTable =
+{
+    // The platform usually sends a burst of notifications when the user changes
+    // something, collect them for about one frame before re-reading the settings.
+    FramelessConfigValueEntry{ "FRAMELESSHELPER_SYSTEM_SETTING_CHANGE_LATENCY", "Values/SystemSettingChangeLatency", FramelessConfigValueType::Duration, 16, 0, 10000 },
+    FramelessConfigValueEntry{ "FRAMELESSHELPER_REPAINT_DELAY", "Values/RepaintDelay", FramelessConfigValueType::Duration, 300, 0, 10000 },
+    FramelessConfigValueEntry{ "FRAMELESSHELPER_MICA_BLUR_RADIUS", "Values/MicaBlurRadius", FramelessConfigValueType::Integer, 128, 0, 512 },
+    FramelessConfigValueEntry{ "FRAMELESSHELPER_OVERRIDE_THEME", "Values/OverrideTheme", FramelessConfigValueType::Enum,
+        static_cast<int>(SystemTheme::Unknown), static_cast<int>(SystemTheme::Unknown), static_cast<int>(SystemTheme::HighContrast),
+        &QMetaEnum::fromType<SystemTheme> }
+};
+
+static constexpr const auto ValueCount = std::size(FramelessValuesTable);
+
 struct FramelessConfigData
 {
     bool loaded = false;
-    std::array<bool, OptionCount> options = {};
+    std::atomic<quint32> options = 0;
+    std::array<std::atomic<int>, ValueCount> values = {};
     bool disableEnvVar = false;
     bool disableCfgFile = false;
+    QFileSystemWatcher *watcher = nullptr;
+    QTimer *reloadTimer = nullptr;
+
+    FramelessConfigData();
+    ~FramelessConfigData();
+
+private:
+    FRAMELESSHELPER_CLASS(FramelessConfigData)
 };
 
+FramelessConfigData::FramelessConfigData()
+{
+    for (int i = 0; i != ValueCount; ++i) {
+        values.at(i).store(FramelessValuesTable.at(i).defaultValue, std::memory_order_relaxed);
+    }
+}
+
+FramelessConfigData::~FramelessConfigData() = default;
+
 Q_GLOBAL_STATIC(FramelessConfigData, g_framelessConfigData)
 
+[[nodiscard]] static inline constexpr quint32 optionMask(const int index)
+{
+    return (quint32(1) << index);
+}
+
+[[nodiscard]] static inline QString configFilePath()
+{
+    if (!qApp) {
+        return {};
+    }
+    const QDir appDir(QCoreApplication::applicationDirPath());
+    return appDir.filePath(FRAMELESSHELPER_STRING_LITERAL(".framelesshelper.ini"));
+}
+
+[[nodiscard]] static inline std::optional<int> parseConfigValue(const FramelessConfigValueEntry &entry, const QString &text)
+{
+    QString str = text.trimmed();
+    if (str.isEmpty()) {
+        return std::nullopt;
+    }
+    int multiplier = 1;
+    if (entry.type == FramelessConfigValueType::Enum) {
+        Q_ASSERT(entry.metaEnum);
+        const QMetaEnum metaEnum = entry.metaEnum();
+        for (int i = 0; i != metaEnum.keyCount(); ++i) {
+            if (str.compare(QUtf8String(metaEnum.key(i)), Qt::CaseInsensitive) == 0) {
+                return metaEnum.value(i);
+            }
+        }
+    } else if (entry.type == FramelessConfigValueType::Duration) {
+        if (str.endsWith(FRAMELESSHELPER_STRING_LITERAL("ms"), Qt::CaseInsensitive)) {
+            str.chop(2);
+        } else if (str.endsWith(u's', Qt::CaseInsensitive)) {
+            str.chop(1);
+            multiplier = 1000;
+        }
+    }
+    bool ok = false;
+    const int value = str.trimmed().toInt(&ok);
+    if (!ok || ((entry.type == FramelessConfigValueType::Enum) && !entry.metaEnum().valueToKey(value))) {
+        WARNING << "Invalid value for" << entry.cfg << ':' << text;
+        return std::nullopt;
+    }
+    return std::clamp(value * multiplier, entry.minimumValue, entry.maximumValue);
+}
+
 #if FRAMELESSHELPER_CONFIG(debug_output)
 static inline void warnInappropriateOptions()
 {
@@ -117,7 +228,18 @@ static inline void warnInappropriateOptions()
 
 FramelessConfig::FramelessConfig(QObject *parent) : QObject(parent)
 {
+    // instance() may be called for the first time from a worker thread (the one
+    // generating the wallpaper, for example), but the objects we create for the
+    // automatic reloading need to live in the application thread.
+    if (const QCoreApplication * const app = QCoreApplication::instance()) {
+        if (thread() != app->thread()) {
+            moveToThread(app->thread());
+        }
+    }
     reload();
+    if (qEnvironmentVariableIntValue("FRAMELESSHELPER_CONFIG_AUTO_RELOAD") != 0) {
+        setAutoReloadEnabled(true);
+    }
 }
 
 FramelessConfig::~FramelessConfig() = default;
@@ -130,25 +252,62 @@ FramelessConfig *FramelessConfig::instance()
 
 void FramelessConfig::reload(const bool force)
 {
-    if (g_framelessConfigData()->loaded && !force) {
+    FramelessConfigData * const data = g_framelessConfigData();
+    if (data->loaded && !force) {
         return;
     }
+    const StartupTraceScope trace("FramelessConfig::reload");
     const auto configFile = []() -> std::unique_ptr<QSettings> {
-        if (!qApp) {
+        const QString filePath = configFilePath();
+        if (filePath.isEmpty()) {
             return nullptr;
         }
-        const QDir appDir(QCoreApplication::applicationDirPath());
-        return std::make_unique<QSettings>(appDir.filePath(FRAMELESSHELPER_STRING_LITERAL(".framelesshelper.ini")), QSettings::IniFormat);
+        return std::make_unique<QSettings>(filePath, QSettings::IniFormat);
     }();
+    quint32 options = 0;
     for (int i = 0; i != OptionCount; ++i) {
-        const bool envVar = (!g_framelessConfigData()->disableEnvVar
+        const bool envVar = (!data->disableEnvVar
             && qEnvironmentVariableIsSet(FramelessOptionsTable.at(i).env)
             && (qEnvironmentVariableIntValue(FramelessOptionsTable.at(i).env) > 0));
-        const bool cfgFile = (!g_framelessConfigData()->disableCfgFile && configFile
+        const bool cfgFile = (!data->disableCfgFile && configFile
             && configFile->value(QUtf8String(FramelessOptionsTable.at(i).cfg), false).toBool());
-        g_framelessConfigData()->options.at(i) = (envVar || cfgFile);
+        if (envVar || cfgFile) {
+            options |= optionMask(i);
+        }
+    }
+    std::array<int, ValueCount> values = {};
+    for (int i = 0; i != ValueCount; ++i) {
+        const FramelessConfigValueEntry &entry = FramelessValuesTable.at(i);
+        // The environment variables have higher priority than the configuration file.
+        std::optional<int> value = std::nullopt;
+        if (!data->disableEnvVar && qEnvironmentVariableIsSet(entry.env)) {
+            value = parseConfigValue(entry, qEnvironmentVariable(entry.env));
+        }
+        if (!value.has_value() && !data->disableCfgFile && configFile) {
+            value = parseConfigValue(entry, configFile->value(QUtf8String(entry.cfg)).toString());
+        }
+        values.at(i) = value.value_or(entry.defaultValue);
+    }
+    const bool notify = data->loaded;
+    const quint32 oldOptions = data->options.exchange(options, std::memory_order_relaxed);
+    std::array<int, ValueCount> oldValues = {};
+    for (int i = 0; i != ValueCount; ++i) {
+        oldValues.at(i) = data->values.at(i).exchange(values.at(i), std::memory_order_relaxed);
+    }
+    data->loaded = true;
+    if (notify) {
+        for (int i = 0; i != OptionCount; ++i) {
+            const bool on = (options & optionMask(i));
+            if (!isPinned(static_cast<Option>(i)) && (bool(oldOptions & optionMask(i)) != on)) {
+                Q_EMIT optionChanged(static_cast<Option>(i), on);
+            }
+        }
+        for (int i = 0; i != ValueCount; ++i) {
+            if (oldValues.at(i) != values.at(i)) {
+                Q_EMIT valueChanged(static_cast<ConfigValue>(i), values.at(i));
+            }
+        }
     }
-    g_framelessConfigData()->loaded = true;
 #if FRAMELESSHELPER_CONFIG(debug_output)
     QTimer::singleShot(0, this, [](){ warnInappropriateOptions(); });
 #endif
@@ -156,12 +315,95 @@ void FramelessConfig::reload(const bool force)
 
 void FramelessConfig::set(const Option option, const bool on)
 {
-    g_framelessConfigData()->options.at(static_cast<int>(option)) = on;
+    if (isPinned(option)) {
+        WARNING << option << "has been pinned at build time, it can't be changed.";
+        return;
+    }
+    const quint32 mask = optionMask(static_cast<int>(option));
+    std::atomic<quint32> &options = g_framelessConfigData()->options;
+    const quint32 oldOptions = (on ? options.fetch_or(mask, std::memory_order_relaxed) : options.fetch_and(~mask, std::memory_order_relaxed));
+    if (bool(oldOptions & mask) != on) {
+        Q_EMIT optionChanged(option, on);
+    }
+}
+
+bool FramelessConfig::isSetAtRuntime(const Option option) const
+{
+    return (g_framelessConfigData()->options.load(std::memory_order_relaxed) & optionMask(static_cast<int>(option)));
+}
+
+void FramelessConfig::setValue(const ConfigValue key, const int value)
+{
+    const FramelessConfigValueEntry &entry = FramelessValuesTable.at(static_cast<int>(key));
+    const int newValue = std::clamp(value, entry.minimumValue, entry.maximumValue);
+    if (g_framelessConfigData()->values.at(static_cast<int>(key)).exchange(newValue, std::memory_order_relaxed) != newValue) {
+        Q_EMIT valueChanged(key, newValue);
+    }
+}
+
+int FramelessConfig::value(const ConfigValue key) const
+{
+    return g_framelessConfigData()->values.at(static_cast<int>(key)).load(std::memory_order_relaxed);
+}
+
+std::chrono::milliseconds FramelessConfig::duration(const ConfigValue key) const
+{
+    Q_ASSERT(FramelessValuesTable.at(static_cast<int>(key)).type == FramelessConfigValueType::Duration);
+    return std::chrono::milliseconds(value(key));
+}
+
+void FramelessConfig::setAutoReloadEnabled(const bool on)
+{
+    // The watcher and the timer are our children, so they must be created in our thread.
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, on](){ setAutoReloadEnabled(on); }, Qt::QueuedConnection);
+        return;
+    }
+    FramelessConfigData * const data = g_framelessConfigData();
+    if (isAutoReloadEnabled() == on) {
+        return;
+    }
+    if (!on) {
+        delete data->watcher;
+        data->watcher = nullptr;
+        delete data->reloadTimer;
+        data->reloadTimer = nullptr;
+        return;
+    }
+    const QString filePath = configFilePath();
+    if (filePath.isEmpty()) {
+        WARNING << "Can't watch the configuration file before the application object has been created.";
+        return;
+    }
+    data->reloadTimer = new QTimer(this);
+    data->reloadTimer->setSingleShot(true);
+    data->reloadTimer->setInterval(kAutoReloadDelay);
+    connect(data->reloadTimer, &QTimer::timeout, this, [this, filePath](){
+        FramelessConfigData * const data = g_framelessConfigData();
+        // Saving a file by replacing it removes it from the watch list, and the
+        // file may not have existed at all when we started watching.
+        if (data->watcher && !data->watcher->files().contains(filePath) && QFileInfo::exists(filePath)) {
+            data->watcher->addPath(filePath);
+        }
+        reload(true);
+    });
+    // Watch the directory as well, otherwise we won't notice the file being created.
+    data->watcher = new QFileSystemWatcher(this);
+    data->watcher->addPath(QFileInfo(filePath).absolutePath());
+    if (QFileInfo::exists(filePath)) {
+        data->watcher->addPath(filePath);
+    }
+    const auto scheduleReload = [data](const QString &path){
+        Q_UNUSED(path);
+        data->reloadTimer->start();
+    };
+    connect(data->watcher, &QFileSystemWatcher::fileChanged, this, scheduleReload);
+    connect(data->watcher, &QFileSystemWatcher::directoryChanged, this, scheduleReload);
 }
 
-bool FramelessConfig::isSet(const Option option) const
+bool FramelessConfig::isAutoReloadEnabled() const
 {
-    return g_framelessConfigData()->options.at(static_cast<int>(option));
+    return (g_framelessConfigData()->watcher != nullptr);
 }
 
 void FramelessConfig::setLoadFromEnvironmentVariablesDisabled(const bool on)
@@ -30,6 +30,7 @@
 #include "framelessmanager_p.h"
 #include "framelessconfig_p.h"
 #include "framelesshelpercore_global_p.h"
+#include "performancecounters_p.h"
 #include "utils.h"
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qevent.h>
@@ -125,20 +126,16 @@ void FramelessHelperQt::addWindow(const QObject *window)
         return;
     }
     data->frameless = true;
-    static const auto shouldApplyFramelessFlag = []() -> bool {
-#ifdef Q_OS_MACOS
-        return false;
-#elif (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
-        return !Utils::isCustomDecorationSupported();
-#elif defined(Q_OS_WINDOWS)
-        return true;
-#endif // Q_OS_MACOS
-    }();
 #if (defined(Q_OS_MACOS) && (QT_VERSION < QT_VERSION_CHECK(6, 0, 0)))
     qWindow->setProperty("_q_mac_wantsLayer", 1);
 #endif // (defined(Q_OS_MACOS) && (QT_VERSION < QT_VERSION_CHECK(6, 0, 0)))
-    if (shouldApplyFramelessFlag) {
-        data->callbacks->setWindowFlags(data->callbacks->getWindowFlags() | Qt::FramelessWindowHint);
+    if (FramelessManagerPrivate::shouldApplyFramelessWindowHint()) {
+        // The helpers apply the hint before creating the native window when they can,
+        // don't touch the flags again in that case.
+        const Qt::WindowFlags flags = data->callbacks->getWindowFlags();
+        if (!(flags & Qt::FramelessWindowHint)) {
+            data->callbacks->setWindowFlags(flags | Qt::FramelessWindowHint);
+        }
     } else {
 #if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
         std::ignore = Utils::tryHideSystemTitleBar(data->callbacks->getWindowId(), true);
@@ -185,6 +182,8 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
     if (!object || !event) {
         return false;
     }
+    FRAMELESSHELPER_PERFORMANCE_COUNT(FilteredEvents);
+    FRAMELESSHELPER_PERFORMANCE_TIME_SCOPE(EventHandling);
 #if (QT_VERSION < QT_VERSION_CHECK(6, 5, 0))
     if (Utils::isThemeChangeEvent(event)) {
         // Sometimes the FramelessManager instance may be destroyed already.
@@ -1366,14 +1366,21 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
     }
 #endif
 
-    const bool wallpaperChanged = ((uMsg == WM_SETTINGCHANGE) && (wParam == SPI_SETDESKWALLPAPER));
-    bool systemThemeChanged = ((uMsg == WM_THEMECHANGED) || (uMsg == WM_SYSCOLORCHANGE)
-                               || (uMsg == WM_DWMCOLORIZATIONCOLORCHANGED));
+    SystemSettingChanges systemSettingChanges = {};
+    if ((uMsg == WM_SETTINGCHANGE) && (wParam == SPI_SETDESKWALLPAPER)) {
+        systemSettingChanges |= SystemSettingChange::Wallpaper;
+    }
+    if ((uMsg == WM_THEMECHANGED) || (uMsg == WM_SYSCOLORCHANGE)) {
+        systemSettingChanges |= (SystemSettingChange::Theme | SystemSettingChange::AccentColor);
+    }
+    if (uMsg == WM_DWMCOLORIZATIONCOLORCHANGED) {
+        systemSettingChanges |= (SystemSettingChange::AccentColor | SystemSettingChange::ColorizationArea);
+    }
     if (WindowsVersionHelper::isWin10RS1OrGreater()) {
         if (uMsg == WM_SETTINGCHANGE) {
             if ((wParam == 0) && (lParam != 0) // lParam sometimes may be NULL.
                 && (std::wcscmp(reinterpret_cast<LPCWSTR>(lParam), kThemeSettingChangeEventName) == 0)) {
-                systemThemeChanged = true;
+                systemSettingChanges |= (SystemSettingChange::Theme | SystemSettingChange::AccentColor | SystemSettingChange::ColorizationArea);
                 if (WindowsVersionHelper::isWin10RS5OrGreater()) {
                     const bool dark = (FramelessManager::instance()->systemTheme() == SystemTheme::Dark);
                     const auto isWidget = [&data]() -> bool {
@@ -1389,16 +1396,11 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
             }
         }
     }
-    if (systemThemeChanged || wallpaperChanged) {
+    if (systemSettingChanges != SystemSettingChanges{}) {
         // Sometimes the FramelessManager instance may be destroyed already.
         if (FramelessManager * const manager = FramelessManager::instance()) {
             if (FramelessManagerPrivate * const managerPriv = FramelessManagerPrivate::get(manager)) {
-                if (systemThemeChanged) {
-                    managerPriv->notifySystemThemeHasChangedOrNot();
-                }
-                if (wallpaperChanged) {
-                    managerPriv->notifyWallpaperHasChangedOrNot();
-                }
+                managerPriv->notifySystemSettingsChanged(systemSettingChanges);
             }
         }
     }
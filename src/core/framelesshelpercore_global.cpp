@@ -25,6 +25,8 @@
 #include "framelesshelpercore_global.h"
 #include "framelesshelpercore_global_p.h"
 #include "versionnumber_p.h"
+#include "sysapiloader_p.h"
+#include "startuptrace_p.h"
 #include "utils.h"
 #include <QtCore/qiodevice.h>
 #include <QtCore/qcoreapplication.h>
@@ -139,6 +141,8 @@ void FramelessHelperCoreInitialize()
     }
     inited = true;
 
+    const StartupTraceScope trace("FramelessHelperCoreInitialize");
+
     FramelessHelperPrintLogo();
 
 #if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
@@ -153,6 +157,14 @@ void FramelessHelperCoreInitialize()
     //gtk_init(nullptr, nullptr); // Users report that GTK functionalities won't work without this.
 #endif
 
+    // Resolving the dynamically loaded system APIs on first use may stall the GUI thread
+    // (the libraries need to be located and opened first), so allow the users to resolve
+    // all of them in a background thread as early as possible instead.
+    if (qEnvironmentVariableIntValue("FRAMELESSHELPER_PRELOAD_SYSTEM_LIBRARIES") != 0) {
+        const StartupTraceScope preloadTrace("PreloadSystemLibraries");
+        SysApiLoader::instance()->preloadPlatformSymbols();
+    }
+
 #if (defined(Q_OS_MACOS) && (QT_VERSION < QT_VERSION_CHECK(6, 0, 0)))
     qputenv("QT_MAC_WANTS_LAYER", "1");
 #endif
@@ -240,6 +252,8 @@ void FramelessHelperEnableThemeAware()
     }
     set = true;
 
+    const StartupTraceScope trace("FramelessHelperEnableThemeAware");
+
 #ifdef Q_OS_WINDOWS
     // This hack is needed to let AllowDarkModeForWindow() work.
     std::ignore = Utils::setDarkModeAllowedForApp(true);
@@ -250,9 +264,10 @@ void FramelessHelperEnableThemeAware()
 #  endif
 #endif
 
-#if ((defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && (QT_VERSION < QT_VERSION_CHECK(6, 4, 0))) || \
+#if ((defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && ((QT_VERSION < QT_VERSION_CHECK(6, 4, 0)) || FRAMELESSHELPER_CONFIG(xdg_portal))) || \
     (defined(Q_OS_MACOS) && (QT_VERSION < QT_VERSION_CHECK(5, 12, 0))))
-    // Linux: Qt 6.4 gained the ability to detect system theme change.
+    // Linux: Qt 6.4 gained the ability to detect system theme change, but we still
+    // need the XDG desktop portal to get notified about the wallpaper changes.
     // macOS: Qt 5.12.
     std::ignore = Utils::registerThemeChangeNotification();
 #endif
@@ -264,6 +279,7 @@ void FramelessHelperPrintLogo()
     if (noLogo) {
         return;
     }
+    const StartupTraceScope trace("FramelessHelperPrintLogo");
     const VersionInfo ver = FramelessHelperVersion();
     QString message = {};
     QTextStream stream(&message, QIODevice::WriteOnly);
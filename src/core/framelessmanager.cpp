@@ -36,11 +36,14 @@
 #  include "framelesshelper_qt.h"
 #endif
 #include "framelessconfig_p.h"
+#include "startuptrace_p.h"
+#include "performancecounters_p.h"
 #include "utils.h"
 #ifdef Q_OS_WINDOWS
 #  include "winverhelper_p.h"
 #endif
 #include <QtCore/qvariant.h>
+#include <utility>
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qfontdatabase.h>
@@ -67,8 +70,6 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
-static constexpr const int kEventDelayInterval = 1000;
-
 struct InternalData
 {
     FramelessDataHash dataMap = {};
@@ -87,6 +88,9 @@ InternalData::~InternalData() = default;
 
 Q_GLOBAL_STATIC(InternalData, g_internalData)
 
+// Only touched from the GUI thread, like the rest of the registration code.
+static int g_registrationBatchDepth = 0;
+
 #if FRAMELESSHELPER_CONFIG(bundle_resource)
 [[nodiscard]] static inline QString iconFontFamilyName()
 {
@@ -135,6 +139,33 @@ bool InternalEventFilter::eventFilter(QObject *object, QEvent *event)
     return false;
 }
 
+FramelessRegistrationBatch::FramelessRegistrationBatch(const int windowCount)
+{
+    ++g_registrationBatchDepth;
+    if (windowCount <= 0) {
+        return;
+    }
+    InternalData * const data = g_internalData();
+    data->dataMap.reserve(data->dataMap.size() + windowCount);
+    data->windowMap.reserve(data->windowMap.size() + windowCount);
+}
+
+FramelessRegistrationBatch::~FramelessRegistrationBatch()
+{
+    Q_ASSERT(g_registrationBatchDepth > 0);
+    if (--g_registrationBatchDepth > 0) {
+        return;
+    }
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    Utils::x11_flush();
+#endif
+}
+
+bool FramelessRegistrationBatch::isActive()
+{
+    return (g_registrationBatchDepth > 0);
+}
+
 FramelessManagerPrivate::FramelessManagerPrivate(FramelessManager *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -173,6 +204,7 @@ void FramelessManagerPrivate::initializeIconFont()
         return;
     }
     inited = true;
+    const StartupTraceScope trace("FramelessManagerPrivate::initializeIconFont");
     FramelessHelperCoreInitResource();
     // We always register this font because it's our only fallback.
     const int id = QFontDatabase::addApplicationFont(FRAMELESSHELPER_STRING_LITERAL(":/org.wangwenx190.FramelessHelper/resources/fonts/iconfont.ttf"));
@@ -184,10 +216,31 @@ void FramelessManagerPrivate::initializeIconFont()
 #endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
 }
 
+bool FramelessManagerPrivate::shouldApplyFramelessWindowHint()
+{
+#if FRAMELESSHELPER_CONFIG(native_impl)
+    // The native implementations remove the system frame themselves.
+    return false;
+#else // !FRAMELESSHELPER_CONFIG(native_impl)
+    static const auto result = []() -> bool {
+#  ifdef Q_OS_MACOS
+        return false;
+#  elif (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+        return !Utils::isCustomDecorationSupported();
+#  else
+        return true;
+#  endif
+    }();
+    return result;
+#endif // FRAMELESSHELPER_CONFIG(native_impl)
+}
+
 QFont FramelessManagerPrivate::getIconFont()
 {
 #if FRAMELESSHELPER_CONFIG(bundle_resource)
     static const auto font = []() -> QFont {
+        // Registering the font is deferred until somebody actually wants to draw a glyph.
+        initializeIconFont();
         QFont f = {};
         f.setFamily(iconFontFamilyName());
 #  ifdef Q_OS_MACOS
@@ -205,40 +258,63 @@ QFont FramelessManagerPrivate::getIconFont()
 
 void FramelessManagerPrivate::notifySystemThemeHasChangedOrNot()
 {
-    themeTimer.start();
+    notifySystemSettingsChanged(SystemSettingChange::Theme | SystemSettingChange::AccentColor | SystemSettingChange::ColorizationArea);
 }
 
 void FramelessManagerPrivate::notifyWallpaperHasChangedOrNot()
 {
-    wallpaperTimer.start();
+    notifySystemSettingsChanged(SystemSettingChange::Wallpaper);
 }
 
-void FramelessManagerPrivate::doNotifySystemThemeHasChangedOrNot()
+void FramelessManagerPrivate::notifySystemSettingsChanged(const SystemSettingChanges changes)
 {
-    const SystemTheme currentSystemTheme = (Utils::shouldAppsUseDarkMode() ? SystemTheme::Dark : SystemTheme::Light);
-    const QColor currentAccentColor = Utils::getAccentColor();
-#ifdef Q_OS_WINDOWS
-    const DwmColorizationArea currentColorizationArea = Utils::getDwmColorizationArea();
-#endif
-    bool notify = false;
-    if (systemTheme != currentSystemTheme) {
-        systemTheme = currentSystemTheme;
-        notify = true;
+    if (changes == SystemSettingChange::None) {
+        return;
     }
-    if (accentColor != currentAccentColor) {
-        accentColor = currentAccentColor;
-        notify = true;
+    pendingChanges |= changes;
+    // Don't restart a running timer, a steady stream of notifications must not
+    // postpone the refresh forever.
+    if (!changeTimer.isActive()) {
+        changeTimer.start();
+    }
+}
+
+void FramelessManagerPrivate::refreshSystemSettings(const SystemSettingChanges changes)
+{
+    Q_Q(FramelessManager);
+    bool colorSchemeChanged = false;
+    bool accentColorChanged = false;
+    bool colorizationAreaChanged = false;
+    bool wallpaperChanged = false;
+    QMutexLocker locker(&settingsMutex);
+    // Facets that have never been queried can't be outdated: nobody has seen
+    // them yet, and they will be read from scratch when they are first needed.
+    if (systemThemeLoaded && changes.testFlag(SystemSettingChange::Theme)) {
+        const SystemTheme currentSystemTheme = (Utils::shouldAppsUseDarkMode() ? SystemTheme::Dark : SystemTheme::Light);
+        if (systemTheme != currentSystemTheme) {
+            systemTheme = currentSystemTheme;
+            colorSchemeChanged = true;
+        }
+    }
+    if (systemThemeLoaded && changes.testFlag(SystemSettingChange::AccentColor)) {
+        const QColor currentAccentColor = Utils::getAccentColor();
+        if (accentColor != currentAccentColor) {
+            accentColor = currentAccentColor;
+            accentColorChanged = true;
+        }
     }
 #ifdef Q_OS_WINDOWS
-    if (colorizationArea != currentColorizationArea) {
-        colorizationArea = currentColorizationArea;
-        notify = true;
+    if (systemThemeLoaded && changes.testFlag(SystemSettingChange::ColorizationArea)) {
+        const DwmColorizationArea currentColorizationArea = Utils::getDwmColorizationArea();
+        if (colorizationArea != currentColorizationArea) {
+            colorizationArea = currentColorizationArea;
+            colorizationAreaChanged = true;
+        }
     }
 #endif
-    // Don't emit the signal if the user has overrided the global theme.
-    if (notify && !isThemeOverrided()) {
-        Q_Q(FramelessManager);
-        Q_EMIT q->systemThemeChanged();
+    // Don't emit the signals if the user has overrided the global theme.
+    const bool themeChanged = (!isThemeOverrided() && (colorSchemeChanged || accentColorChanged || colorizationAreaChanged));
+    if (themeChanged) {
         DEBUG.nospace() << "System theme changed. Current theme: " << systemTheme
                         << ", accent color: " << accentColor.name(QColor::HexArgb).toUpper()
 #ifdef Q_OS_WINDOWS
@@ -246,26 +322,38 @@ void FramelessManagerPrivate::doNotifySystemThemeHasChangedOrNot()
 #endif
                         << '.';
     }
-}
-
-void FramelessManagerPrivate::doNotifyWallpaperHasChangedOrNot()
-{
-    const QString currentWallpaper = Utils::getWallpaperFilePath();
-    const WallpaperAspectStyle currentWallpaperAspectStyle = Utils::getWallpaperAspectStyle();
-    bool notify = false;
-    if (wallpaper != currentWallpaper) {
-        wallpaper = currentWallpaper;
-        notify = true;
+    if (wallpaperLoaded && changes.testFlag(SystemSettingChange::Wallpaper)) {
+        const QString currentWallpaper = Utils::getWallpaperFilePath();
+        const WallpaperAspectStyle currentWallpaperAspectStyle = Utils::getWallpaperAspectStyle();
+        if (wallpaper != currentWallpaper) {
+            wallpaper = currentWallpaper;
+            wallpaperChanged = true;
+        }
+        if (wallpaperAspectStyle != currentWallpaperAspectStyle) {
+            wallpaperAspectStyle = currentWallpaperAspectStyle;
+            wallpaperChanged = true;
+        }
+        if (wallpaperChanged) {
+            DEBUG.nospace() << "Wallpaper changed. Current wallpaper: " << wallpaper
+                            << ", aspect style: " << wallpaperAspectStyle << '.';
+        }
     }
-    if (wallpaperAspectStyle != currentWallpaperAspectStyle) {
-        wallpaperAspectStyle = currentWallpaperAspectStyle;
-        notify = true;
+    // The connected slots will most likely read the new values back.
+    locker.unlock();
+    if (themeChanged) {
+        if (colorSchemeChanged) {
+            Q_EMIT q->systemColorSchemeChanged();
+        }
+        if (accentColorChanged) {
+            Q_EMIT q->systemAccentColorChanged();
+        }
+        if (colorizationAreaChanged) {
+            Q_EMIT q->systemColorizationAreaChanged();
+        }
+        Q_EMIT q->systemThemeChanged();
     }
-    if (notify) {
-        Q_Q(FramelessManager);
+    if (wallpaperChanged) {
         Q_EMIT q->wallpaperChanged();
-        DEBUG.nospace() << "Wallpaper changed. Current wallpaper: " << wallpaper
-                        << ", aspect style: " << wallpaperAspectStyle << '.';
     }
 }
 
@@ -350,31 +438,32 @@ bool FramelessManagerPrivate::isThemeOverrided() const
 
 void FramelessManagerPrivate::initialize()
 {
-    themeTimer.setInterval(kEventDelayInterval);
-    themeTimer.callOnTimeout(this, [this](){
-        themeTimer.stop();
-        doNotifySystemThemeHasChangedOrNot();
+    const StartupTraceScope trace("FramelessManagerPrivate::initialize");
+    FramelessConfig * const config = FramelessConfig::instance();
+    const std::chrono::milliseconds latency = config->duration(ConfigValue::SystemSettingChangeLatency);
+    changeTimer.setSingleShot(true);
+    changeTimer.setInterval(latency);
+    changeTimer.callOnTimeout(this, [this](){
+        const SystemSettingChanges changes = std::exchange(pendingChanges, SystemSettingChange::None);
+        refreshSystemSettings(changes);
     });
-    wallpaperTimer.setInterval(kEventDelayInterval);
-    wallpaperTimer.callOnTimeout(this, [this](){
-        wallpaperTimer.stop();
-        doNotifyWallpaperHasChangedOrNot();
+    const auto configTheme = config->valueAs<SystemTheme>(ConfigValue::OverrideTheme);
+    if (configTheme != SystemTheme::Unknown) {
+        overrideTheme = configTheme;
+    }
+    connect(config, &FramelessConfig::valueChanged, this, [this](const ConfigValue key, const int value){
+        switch (key) {
+        case ConfigValue::SystemSettingChangeLatency:
+            changeTimer.setInterval(value);
+            break;
+        case ConfigValue::OverrideTheme: {
+            Q_Q(FramelessManager);
+            q->setOverrideTheme(static_cast<SystemTheme>(value));
+        } break;
+        default:
+            break;
+        }
     });
-    systemTheme = (Utils::shouldAppsUseDarkMode() ? SystemTheme::Dark : SystemTheme::Light);
-    accentColor = Utils::getAccentColor();
-#ifdef Q_OS_WINDOWS
-    colorizationArea = Utils::getDwmColorizationArea();
-#endif
-    wallpaper = Utils::getWallpaperFilePath();
-    wallpaperAspectStyle = Utils::getWallpaperAspectStyle();
-    DEBUG.nospace() << "Current system theme: " << systemTheme
-                    << ", accent color: " << accentColor.name(QColor::HexArgb).toUpper()
-#ifdef Q_OS_WINDOWS
-                    << ", colorization area: " << colorizationArea
-#endif
-                    << ", wallpaper: " << wallpaper
-                    << ", aspect style: " << wallpaperAspectStyle
-                    << '.';
     // We are doing some tricks in our Windows message handling code, so
     // we don't use Qt's theme notifier on Windows. But for other platforms
     // we want to use as many Qt functionalities as possible.
@@ -384,7 +473,8 @@ void FramelessManagerPrivate::initialize()
     if (styleHints) {
         connect(styleHints, &QStyleHints::colorSchemeChanged, this, [this](const Qt::ColorScheme colorScheme){
             Q_UNUSED(colorScheme);
-            notifySystemThemeHasChangedOrNot();
+            // The accent color we get from the palette may change together with the color scheme.
+            notifySystemSettingsChanged(SystemSettingChange::Theme | SystemSettingChange::AccentColor);
         });
     }
 #endif // ((QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)) && !defined(Q_OS_WINDOWS))
@@ -400,6 +490,39 @@ void FramelessManagerPrivate::initialize()
     }
 }
 
+void FramelessManagerPrivate::ensureSystemTheme()
+{
+    if (systemThemeLoaded) {
+        return;
+    }
+    systemThemeLoaded = true;
+    const StartupTraceScope trace("FramelessManagerPrivate::ensureSystemTheme");
+    systemTheme = (Utils::shouldAppsUseDarkMode() ? SystemTheme::Dark : SystemTheme::Light);
+    accentColor = Utils::getAccentColor();
+#ifdef Q_OS_WINDOWS
+    colorizationArea = Utils::getDwmColorizationArea();
+#endif
+    DEBUG.nospace() << "Current system theme: " << systemTheme
+                    << ", accent color: " << accentColor.name(QColor::HexArgb).toUpper()
+#ifdef Q_OS_WINDOWS
+                    << ", colorization area: " << colorizationArea
+#endif
+                    << '.';
+}
+
+void FramelessManagerPrivate::ensureWallpaper()
+{
+    if (wallpaperLoaded) {
+        return;
+    }
+    wallpaperLoaded = true;
+    const StartupTraceScope trace("FramelessManagerPrivate::ensureWallpaper");
+    wallpaper = Utils::getWallpaperFilePath();
+    wallpaperAspectStyle = Utils::getWallpaperAspectStyle();
+    DEBUG.nospace() << "Current wallpaper: " << wallpaper
+                    << ", aspect style: " << wallpaperAspectStyle << '.';
+}
+
 FramelessManager::FramelessManager(QObject *parent) :
     QObject(parent), d_ptr(std::make_unique<FramelessManagerPrivate>(this))
 {
@@ -420,27 +543,59 @@ SystemTheme FramelessManager::systemTheme() const
     if (d->isThemeOverrided()) {
         return d->overrideTheme.value();
     }
+    const QMutexLocker locker(&d->settingsMutex);
+    const_cast<FramelessManagerPrivate *>(d)->ensureSystemTheme();
     return d->systemTheme;
 }
 
 QColor FramelessManager::systemAccentColor() const
 {
     Q_D(const FramelessManager);
+    const QMutexLocker locker(&d->settingsMutex);
+    const_cast<FramelessManagerPrivate *>(d)->ensureSystemTheme();
     return d->accentColor;
 }
 
 QString FramelessManager::wallpaper() const
 {
     Q_D(const FramelessManager);
+    const QMutexLocker locker(&d->settingsMutex);
+    const_cast<FramelessManagerPrivate *>(d)->ensureWallpaper();
     return d->wallpaper;
 }
 
 WallpaperAspectStyle FramelessManager::wallpaperAspectStyle() const
 {
     Q_D(const FramelessManager);
+    const QMutexLocker locker(&d->settingsMutex);
+    const_cast<FramelessManagerPrivate *>(d)->ensureWallpaper();
     return d->wallpaperAspectStyle;
 }
 
+bool FramelessManager::isPerformanceCountersEnabled()
+{
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+    return true;
+#else
+    return false;
+#endif
+}
+
+quint64 FramelessManager::performanceCounter(const PerformanceCounter counter) const
+{
+    return PerformanceCounters::counter(counter);
+}
+
+PerformanceTimerStatistics FramelessManager::performanceTimer(const PerformanceTimer timer) const
+{
+    return PerformanceCounters::timer(timer);
+}
+
+void FramelessManager::resetPerformanceCounters()
+{
+    PerformanceCounters::reset();
+}
+
 void FramelessManager::setOverrideTheme(const SystemTheme theme)
 {
     Q_D(FramelessManager);
@@ -453,6 +608,7 @@ void FramelessManager::setOverrideTheme(const SystemTheme theme)
     } else {
         d->overrideTheme = theme;
     }
+    Q_EMIT systemColorSchemeChanged();
     Q_EMIT systemThemeChanged();
 }
 
@@ -31,6 +31,7 @@
 #include "utils.h"
 #include "framelessconfig_p.h"
 #include "framelesshelpercore_global_p.h"
+#include "performancecounters_p.h"
 #include <optional>
 #include <memory>
 #include <QtCore/qsysinfo.h>
@@ -70,7 +71,6 @@ using namespace Global;
 
 [[maybe_unused]] static constexpr const qreal kDefaultTintOpacity = 0.7;
 [[maybe_unused]] static constexpr const qreal kDefaultNoiseOpacity = 0.04;
-[[maybe_unused]] static constexpr const qreal kDefaultBlurRadius = 128.0;
 
 [[maybe_unused]] static Q_COLOR_CONSTEXPR const QColor kDefaultSystemLightColor2 = {243, 243, 243}; // #F3F3F3
 
@@ -494,6 +494,8 @@ void WallpaperThread::run()
 void WallpaperThread::start()
 #endif
 {
+    FRAMELESSHELPER_PERFORMANCE_COUNT(WallpaperRegenerations);
+    FRAMELESSHELPER_PERFORMANCE_TIME_SCOPE(WallpaperGeneration);
     const QString wallpaperFilePath = Utils::getWallpaperFilePath();
     if (wallpaperFilePath.isEmpty()) {
         WARNING << "Failed to retrieve the wallpaper file path.";
@@ -576,7 +578,9 @@ void WallpaperThread::start()
         painter.setRenderHint(QPainter::TextAntialiasing, false);
         painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
 #if FRAMELESSHELPER_CONFIG(private_qt)
-        qt_blurImage(&painter, buffer, kDefaultBlurRadius, false, false);
+        // We are on a worker thread here, but reading the configuration is thread-safe.
+        const auto blurRadius = qreal(FramelessConfig::instance()->value(ConfigValue::MicaBlurRadius));
+        qt_blurImage(&painter, buffer, blurRadius, false, false);
 #else // !FRAMELESSHELPER_CONFIG(private_qt)
         painter.drawImage(desktopOriginPoint, buffer);
 #endif // FRAMELESSHELPER_CONFIG(private_qt)
@@ -726,7 +730,8 @@ void MicaMaterialPrivate::initialize()
 
     updateMaterialBrush();
 
-    connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged,
+    // The material brush only depends on the color scheme, don't rebuild it for accent color changes.
+    connect(FramelessManager::instance(), &FramelessManager::systemColorSchemeChanged,
         this, &MicaMaterialPrivate::updateMaterialBrush);
     connect(FramelessManager::instance(), &FramelessManager::wallpaperChanged,
         this, &MicaMaterialPrivate::forceRebuildWallpaper);
@@ -763,6 +768,26 @@ QColor MicaMaterialPrivate::systemFallbackColor()
     return ((FramelessManager::instance()->systemTheme() == SystemTheme::Dark) ? kDefaultFallbackColorDark : kDefaultFallbackColorLight);
 }
 
+QImage MicaMaterialPrivate::halfScaled(const QImage &image)
+{
+#if FRAMELESSHELPER_CONFIG(private_qt)
+    return qt_halfScaled(image);
+#else
+    return image;
+#endif
+}
+
+void MicaMaterialPrivate::blurImage(QImage &image, const qreal radius, const bool quality)
+{
+#if FRAMELESSHELPER_CONFIG(private_qt)
+    qt_blurImage(nullptr, image, radius, quality, false);
+#else
+    Q_UNUSED(image);
+    Q_UNUSED(radius);
+    Q_UNUSED(quality);
+#endif
+}
+
 QPoint MicaMaterialPrivate::mapToWallpaper(const QPoint &pos) const
 {
     if (pos.isNull()) {
@@ -0,0 +1,160 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "performancecounters_p.h"
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+#  include <array>
+#  include <atomic>
+#endif
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+using namespace Global;
+
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+static constexpr const auto kPerformanceCounterCount = (static_cast<int>(PerformanceCounter::Last) + 1);
+static constexpr const auto kPerformanceTimerCount = (static_cast<int>(PerformanceTimer::Last) + 1);
+
+struct PerformanceTimerData
+{
+    std::atomic<quint64> count = 0;
+    std::atomic<quint64> totalTime = 0;
+    std::atomic<quint64> maximumTime = 0;
+};
+
+struct PerformanceCountersData
+{
+    // Relaxed ordering everywhere: these are statistics, nobody synchronizes on them.
+    std::array<std::atomic<quint64>, kPerformanceCounterCount> counters = {};
+    std::array<PerformanceTimerData, kPerformanceTimerCount> timers = {};
+
+    PerformanceCountersData();
+    ~PerformanceCountersData();
+
+private:
+    FRAMELESSHELPER_CLASS(PerformanceCountersData)
+};
+
+PerformanceCountersData::PerformanceCountersData() = default;
+
+PerformanceCountersData::~PerformanceCountersData() = default;
+
+Q_GLOBAL_STATIC(PerformanceCountersData, g_performanceCountersData)
+#endif // FRAMELESSHELPER_CONFIG(performance_counters)
+
+void PerformanceCounters::increment(const PerformanceCounter counter)
+{
+    add(counter, 1);
+}
+
+void PerformanceCounters::add(const PerformanceCounter counter, const quint64 value)
+{
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+    if (PerformanceCountersData * const data = g_performanceCountersData()) {
+        data->counters.at(static_cast<int>(counter)).fetch_add(value, std::memory_order_relaxed);
+    }
+#else // !FRAMELESSHELPER_CONFIG(performance_counters)
+    Q_UNUSED(counter);
+    Q_UNUSED(value);
+#endif // FRAMELESSHELPER_CONFIG(performance_counters)
+}
+
+void PerformanceCounters::record(const PerformanceTimer timer, const quint64 nsecs)
+{
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+    PerformanceCountersData * const data = g_performanceCountersData();
+    if (!data) {
+        return;
+    }
+    PerformanceTimerData &timerData = data->timers.at(static_cast<int>(timer));
+    timerData.count.fetch_add(1, std::memory_order_relaxed);
+    timerData.totalTime.fetch_add(nsecs, std::memory_order_relaxed);
+    quint64 maximumTime = timerData.maximumTime.load(std::memory_order_relaxed);
+    while ((nsecs > maximumTime) && !timerData.maximumTime.compare_exchange_weak(maximumTime, nsecs, std::memory_order_relaxed)) {
+    }
+#else // !FRAMELESSHELPER_CONFIG(performance_counters)
+    Q_UNUSED(timer);
+    Q_UNUSED(nsecs);
+#endif // FRAMELESSHELPER_CONFIG(performance_counters)
+}
+
+quint64 PerformanceCounters::counter(const PerformanceCounter counter)
+{
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+    if (const PerformanceCountersData * const data = g_performanceCountersData()) {
+        return data->counters.at(static_cast<int>(counter)).load(std::memory_order_relaxed);
+    }
+#else // !FRAMELESSHELPER_CONFIG(performance_counters)
+    Q_UNUSED(counter);
+#endif // FRAMELESSHELPER_CONFIG(performance_counters)
+    return 0;
+}
+
+PerformanceTimerStatistics PerformanceCounters::timer(const PerformanceTimer timer)
+{
+    PerformanceTimerStatistics result = {};
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+    if (const PerformanceCountersData * const data = g_performanceCountersData()) {
+        const PerformanceTimerData &timerData = data->timers.at(static_cast<int>(timer));
+        result.count = timerData.count.load(std::memory_order_relaxed);
+        result.totalTime = timerData.totalTime.load(std::memory_order_relaxed);
+        result.maximumTime = timerData.maximumTime.load(std::memory_order_relaxed);
+    }
+#else // !FRAMELESSHELPER_CONFIG(performance_counters)
+    Q_UNUSED(timer);
+#endif // FRAMELESSHELPER_CONFIG(performance_counters)
+    return result;
+}
+
+void PerformanceCounters::reset()
+{
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+    PerformanceCountersData * const data = g_performanceCountersData();
+    if (!data) {
+        return;
+    }
+    for (auto &&counter : data->counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto &&timerData : data->timers) {
+        timerData.count.store(0, std::memory_order_relaxed);
+        timerData.totalTime.store(0, std::memory_order_relaxed);
+        timerData.maximumTime.store(0, std::memory_order_relaxed);
+    }
+#endif // FRAMELESSHELPER_CONFIG(performance_counters)
+}
+
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+PerformanceTimerScope::PerformanceTimerScope(const PerformanceTimer timer) : m_timer(timer)
+{
+    m_elapsedTimer.start();
+}
+
+PerformanceTimerScope::~PerformanceTimerScope()
+{
+    PerformanceCounters::record(m_timer, quint64(m_elapsedTimer.nsecsElapsed()));
+}
+#endif // FRAMELESSHELPER_CONFIG(performance_counters)
+
+FRAMELESSHELPER_END_NAMESPACE
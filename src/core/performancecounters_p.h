@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/performancecounters_p.h"
@@ -510,6 +510,28 @@ QString gtkSettings(const gchar *property)
     g_free(raw);
     return result;
 }
+
+SysApiLoader::Symbols SysApiLoader::platformSymbols()
+{
+    Symbols symbols = {};
+#ifndef FRAMELESSHELPER_HAS_XCB
+    symbols.insert(klibxcb, {
+        kxcb_send_event, kxcb_flush, kxcb_intern_atom, kxcb_intern_atom_reply,
+        kxcb_ungrab_pointer, kxcb_change_property, kxcb_delete_property_checked,
+        kxcb_get_property, kxcb_get_property_reply, kxcb_get_property_value,
+        kxcb_get_property_value_length, kxcb_list_properties, kxcb_list_properties_reply,
+        kxcb_list_properties_atoms_length, kxcb_list_properties_atoms, kxcb_get_property_unchecked
+    });
+#endif // FRAMELESSHELPER_HAS_XCB
+#ifndef FRAMELESSHELPER_HAS_GTK
+    symbols.insert(klibgtk, {
+        kgtk_init, kg_value_init, kg_value_reset, kg_value_unset, kg_value_get_boolean,
+        kg_value_get_string, kgtk_settings_get_default, kg_object_get_property,
+        kg_signal_connect_data, kg_free, kg_object_unref, kg_clear_object
+    });
+#endif // FRAMELESSHELPER_HAS_GTK
+    return symbols;
+}
 FRAMELESSHELPER_END_NAMESPACE
 
 #endif // __linux__
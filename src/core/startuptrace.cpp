@@ -0,0 +1,147 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "startuptrace_p.h"
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+#include <algorithm>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcStartupTrace, "wangwenx190.framelesshelper.core.startuptrace")
+#  define INFO qCInfo(lcStartupTrace)
+#  define DEBUG qCDebug(lcStartupTrace)
+#  define WARNING qCWarning(lcStartupTrace)
+#  define CRITICAL qCCritical(lcStartupTrace)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+// Only the startup is interesting, don't let a phase which can be repeated
+// later (reloading the configuration, for example) grow the list forever.
+static constexpr const int kMaximumStartupPhaseCount = 64;
+
+struct StartupTraceData
+{
+    QMutex mutex;
+    QElapsedTimer clock;
+    QList<StartupPhase> phases = {};
+
+    StartupTraceData();
+    ~StartupTraceData();
+
+private:
+    FRAMELESSHELPER_CLASS(StartupTraceData)
+};
+
+StartupTraceData::StartupTraceData()
+{
+    clock.start();
+}
+
+StartupTraceData::~StartupTraceData() = default;
+
+Q_GLOBAL_STATIC(StartupTraceData, g_startupTraceData)
+
+[[nodiscard]] static inline bool isStartupTraceOutputEnabled()
+{
+    static const bool result = (qEnvironmentVariableIntValue("FRAMELESSHELPER_STARTUP_TRACE") != 0);
+    return result;
+}
+
+StartupTraceScope::StartupTraceScope(const char *name) : m_name(name)
+{
+    Q_ASSERT(m_name);
+    // The clock starts together with the first phase, so all timestamps are
+    // relative to the moment the library started doing any work.
+    if (StartupTraceData * const data = g_startupTraceData()) {
+        m_start = data->clock.nsecsElapsed();
+    }
+}
+
+StartupTraceScope::~StartupTraceScope()
+{
+    StartupTraceData * const data = g_startupTraceData();
+    if (!data) {
+        return;
+    }
+    StartupPhase phase = {};
+    phase.name = m_name;
+    phase.start = m_start;
+    phase.duration = (data->clock.nsecsElapsed() - m_start);
+    {
+        const QMutexLocker locker(&data->mutex);
+        if (data->phases.size() >= kMaximumStartupPhaseCount) {
+            return;
+        }
+        data->phases.append(phase);
+    }
+    if (isStartupTraceOutputEnabled()) {
+        // Not INFO: our own logging is compiled out by default, but the user
+        // explicitly asked for the trace by setting the environment variable.
+        qInfo() << phase;
+    }
+}
+
+QList<StartupPhase> FramelessHelperStartupTrace()
+{
+    StartupTraceData * const data = g_startupTraceData();
+    if (!data) {
+        return {};
+    }
+    QList<StartupPhase> result = {};
+    {
+        const QMutexLocker locker(&data->mutex);
+        result = data->phases;
+    }
+    // Phases are recorded when they finish, so nested phases would otherwise
+    // be listed before the phase that contains them.
+    std::stable_sort(result.begin(), result.end(), [](const StartupPhase &lhs, const StartupPhase &rhs){
+        return (lhs.start < rhs.start);
+    });
+    return result;
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#ifndef QT_NO_DEBUG_STREAM
+QT_BEGIN_NAMESPACE
+QDebug operator<<(QDebug d, const FRAMELESSHELPER_PREPEND_NAMESPACE(Global)::StartupPhase &phase)
+{
+    const QDebugStateSaver saver(d);
+    d.nospace().noquote() << "StartupPhase("
+                          << "name: " << phase.name << ", "
+                          << "start: " << (qreal(phase.start) / qreal(1000000)) << "ms, "
+                          << "duration: " << (qreal(phase.duration) / qreal(1000000)) << "ms)";
+    return d;
+}
+QT_END_NAMESPACE
+#endif // QT_NO_DEBUG_STREAM
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/startuptrace_p.h"
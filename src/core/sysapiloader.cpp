@@ -48,6 +48,10 @@
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qvarlengtharray.h>
+#include <QtCore/qthread.h>
+#include <array>
+#include <atomic>
+#include <memory>
 #if SYSAPILOADER_QSYSTEMLIBRARY
 #  include <QtCore/private/qsystemlibrary_p.h>
 #endif // SYSAPILOADER_QSYSTEMLIBRARY
@@ -70,10 +74,106 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 #  define CRITICAL QT_NO_QDEBUG_MACRO()
 #endif
 
-using SysApiLoaderData = QHash<QString, QFunctionPointer>;
+// We only load a few dozens of symbols in total, so a fixed size table is more than enough.
+static constexpr const quint32 kSysApiLoaderTableSize = 512;
+
+enum class SysApiLoaderEntryState : quint8
+{
+    Empty,
+    Writing,
+    Ready
+};
+
+struct SysApiLoaderEntry
+{
+    std::atomic<SysApiLoaderEntryState> state{ SysApiLoaderEntryState::Empty };
+    // The following members are written only once, before "state" becomes "Ready".
+    size_t hash = 0;
+    QString key = {};
+    QFunctionPointer symbol = nullptr;
+};
+
+// A pre-sized open addressing hash table. Entries are never removed or modified once
+// they are published, so the readers never need to take any locks. Writers claim an
+// empty slot through CAS and publish it with a release store.
+struct SysApiLoaderData
+{
+    std::array<SysApiLoaderEntry, kSysApiLoaderTableSize> entries = {};
+
+    [[nodiscard]] const SysApiLoaderEntry *find(const QString &key, const size_t hash) const
+    {
+        quint32 index = (hash % kSysApiLoaderTableSize);
+        for (quint32 probe = 0; probe != kSysApiLoaderTableSize; ++probe) {
+            const SysApiLoaderEntry &entry = entries.at(index);
+            SysApiLoaderEntryState state = entry.state.load(std::memory_order_acquire);
+            while (state == SysApiLoaderEntryState::Writing) {
+                // Someone else is publishing this slot right now, it won't take long.
+                QThread::yieldCurrentThread();
+                state = entry.state.load(std::memory_order_acquire);
+            }
+            if (state == SysApiLoaderEntryState::Empty) {
+                return nullptr;
+            }
+            if ((entry.hash == hash) && (entry.key == key)) {
+                return &entry;
+            }
+            index = ((index + 1) % kSysApiLoaderTableSize);
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] const SysApiLoaderEntry *insert(const QString &key, const size_t hash, const QFunctionPointer symbol)
+    {
+        quint32 index = (hash % kSysApiLoaderTableSize);
+        for (quint32 probe = 0; probe != kSysApiLoaderTableSize; ++probe) {
+            SysApiLoaderEntry &entry = entries.at(index);
+            auto expected = SysApiLoaderEntryState::Empty;
+            if (entry.state.compare_exchange_strong(expected, SysApiLoaderEntryState::Writing, std::memory_order_acq_rel)) {
+                entry.hash = hash;
+                entry.key = key;
+                entry.symbol = symbol;
+                entry.state.store(SysApiLoaderEntryState::Ready, std::memory_order_release);
+                return &entry;
+            }
+            while (expected == SysApiLoaderEntryState::Writing) {
+                QThread::yieldCurrentThread();
+                expected = entry.state.load(std::memory_order_acquire);
+            }
+            // Another thread may have resolved the same symbol in the mean time.
+            if ((entry.hash == hash) && (entry.key == key)) {
+                return &entry;
+            }
+            index = ((index + 1) % kSysApiLoaderTableSize);
+        }
+        return nullptr;
+    }
+};
 
 Q_GLOBAL_STATIC(SysApiLoaderData, g_sysApiLoaderData)
 
+#if (QT_CONFIG(thread) && (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)))
+#  define SYSAPILOADER_PRELOAD_THREAD (1)
+#else
+#  define SYSAPILOADER_PRELOAD_THREAD (0)
+#endif
+
+#if SYSAPILOADER_PRELOAD_THREAD
+struct SysApiLoaderPreloadData
+{
+    std::unique_ptr<QThread> thread = nullptr;
+
+    ~SysApiLoaderPreloadData()
+    {
+        // Never destroy a running thread, resolving the symbols is fast anyway.
+        if (thread && thread->isRunning()) {
+            thread->wait();
+        }
+    }
+};
+
+Q_GLOBAL_STATIC(SysApiLoaderPreloadData, g_sysApiLoaderPreloadData)
+#endif
+
 #if FRAMELESSHELPER_CONFIG(debug_output)
 [[nodiscard]] static inline bool isDebug()
 {
@@ -82,6 +182,37 @@ Q_GLOBAL_STATIC(SysApiLoaderData, g_sysApiLoaderData)
 }
 #endif
 
+[[nodiscard]] static inline QFunctionPointer resolveAndCache(const QString &library, const QString &function, const bool verbose)
+{
+    const QString key = SysApiLoader::generateUniqueKey(library, function);
+    const size_t hash = qHash(key);
+    if (const SysApiLoaderEntry * const entry = g_sysApiLoaderData()->find(key, hash)) {
+#if FRAMELESSHELPER_CONFIG(debug_output)
+        if (isDebug()) {
+            DEBUG << Q_FUNC_INFO << "Function cache found:" << key;
+        }
+#endif
+        return entry->symbol;
+    }
+    const QFunctionPointer symbol = SysApiLoader::resolve(library, function);
+    if (!g_sysApiLoaderData()->insert(key, hash, symbol)) {
+        WARNING << "The function cache is full, failed to cache" << key;
+    }
+#if FRAMELESSHELPER_CONFIG(debug_output)
+    if (isDebug()) {
+        DEBUG << Q_FUNC_INFO << "New function cache:" << key << (symbol ? "[VALID]" : "[NULL]");
+    }
+#endif
+    if (verbose) {
+        if (symbol) {
+            DEBUG << "Successfully loaded" << function << "from" << library;
+        } else {
+            WARNING << "Failed to load" << function << "from" << library;
+        }
+    }
+    return symbol;
+}
+
 SysApiLoader::SysApiLoader(QObject *parent) : QObject(parent)
 {
 }
@@ -185,31 +316,20 @@ bool SysApiLoader::isAvailable(const QString &library, const QString &function)
     if (library.isEmpty() || function.isEmpty()) {
         return false;
     }
-    const QString key = generateUniqueKey(library, function);
-    const auto it = g_sysApiLoaderData()->constFind(key);
-    if (it != g_sysApiLoaderData()->constEnd()) {
-#if FRAMELESSHELPER_CONFIG(debug_output)
-        if (isDebug()) {
-            DEBUG << Q_FUNC_INFO << "Function cache found:" << key;
-        }
-#endif
-        return (it.value() != nullptr);
-    } else {
-        const QFunctionPointer symbol = SysApiLoader::resolve(library, function);
-        g_sysApiLoaderData()->insert(key, symbol);
-#if FRAMELESSHELPER_CONFIG(debug_output)
-        if (isDebug()) {
-            DEBUG << Q_FUNC_INFO << "New function cache:" << key << (symbol ? "[VALID]" : "[NULL]");
-        }
-#endif
-        if (symbol) {
-            DEBUG << "Successfully loaded" << function << "from" << library;
-            return true;
-        } else {
-            WARNING << "Failed to load" << function << "from" << library;
-            return false;
-        }
+    return (resolveAndCache(library, function, true) != nullptr);
+}
+
+QFunctionPointer SysApiLoader::getOrResolve(const QString &library, const QString &function)
+{
+    Q_ASSERT(!library.isEmpty());
+    Q_ASSERT(!function.isEmpty());
+    if (library.isEmpty() || function.isEmpty()) {
+        return nullptr;
+    }
+    if (!isAvailable(library, function)) {
+        return nullptr;
     }
+    return get(library, function);
 }
 
 QFunctionPointer SysApiLoader::get(const QString &library, const QString &function)
@@ -220,14 +340,13 @@ QFunctionPointer SysApiLoader::get(const QString &library, const QString &functi
         return nullptr;
     }
     const QString key = generateUniqueKey(library, function);
-    const auto it = g_sysApiLoaderData()->constFind(key);
-    if (it != g_sysApiLoaderData()->constEnd()) {
+    if (const SysApiLoaderEntry * const entry = g_sysApiLoaderData()->find(key, qHash(key))) {
 #if FRAMELESSHELPER_CONFIG(debug_output)
         if (isDebug()) {
             DEBUG << Q_FUNC_INFO << "Function cache found:" << key;
         }
 #endif
-        return it.value();
+        return entry->symbol;
     } else {
 #if FRAMELESSHELPER_CONFIG(debug_output)
         if (isDebug()) {
@@ -238,4 +357,52 @@ QFunctionPointer SysApiLoader::get(const QString &library, const QString &functi
     }
 }
 
+#if !(defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+SysApiLoader::Symbols SysApiLoader::platformSymbols()
+{
+    // Only the Linux platform support code loads its dependencies lazily for now.
+    return {};
+}
+#endif
+
+void SysApiLoader::preload(const Symbols &symbols)
+{
+    if (symbols.isEmpty()) {
+        return;
+    }
+    const auto task = [symbols]() -> void {
+        int total = 0;
+        QStringList missing = {};
+        for (auto it = symbols.constBegin(); it != symbols.constEnd(); ++it) {
+            for (auto &&function : std::as_const(it.value())) {
+                ++total;
+                if (!resolveAndCache(it.key(), function, false)) {
+                    missing.append(generateUniqueKey(it.key(), function));
+                }
+            }
+        }
+        if (missing.isEmpty()) {
+            DEBUG << "Successfully preloaded" << total << "system symbols.";
+        } else {
+            WARNING << "Preloaded" << total << "system symbols, the following ones are not available:" << missing;
+        }
+    };
+#if SYSAPILOADER_PRELOAD_THREAD
+    if (g_sysApiLoaderPreloadData()->thread) {
+        WARNING << "The system symbols are being preloaded already.";
+        return;
+    }
+    g_sysApiLoaderPreloadData()->thread.reset(QThread::create(task));
+    g_sysApiLoaderPreloadData()->thread->setObjectName(FRAMELESSHELPER_STRING_LITERAL("FramelessHelperSysApiPreloader"));
+    g_sysApiLoaderPreloadData()->thread->start();
+#else
+    task();
+#endif
+}
+
+void SysApiLoader::preloadPlatformSymbols()
+{
+    preload(platformSymbols());
+}
+
 FRAMELESSHELPER_END_NAMESPACE
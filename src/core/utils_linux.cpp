@@ -29,7 +29,11 @@
 #include "framelessconfig_p.h"
 #include "framelessmanager.h"
 #include "framelessmanager_p.h"
+#include "xdgportalsettings_p.h"
+#include "performancecounters_p.h"
 #include <cstring> // for std::memcpy
+#include <atomic>
+#include <optional>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qevent.h>
 #include <QtGui/qwindow.h>
@@ -90,6 +94,74 @@ static constexpr const auto _XCB_SEND_EVENT_MASK =
 extern template bool gtkSettings<bool>(const gchar *);
 extern QString gtkSettings(const gchar *);
 
+// A typed copy of the GTK theme settings we are interested in. Querying them
+// from GTK directly means a round trip through the dynamically loaded GObject
+// property system each time, so we only refresh them when GTK tells us they
+// have changed and make the theme queries plain memory reads instead.
+struct GtkThemeSettingsData
+{
+    // Set by the first thread that tries to subscribe to the GTK notifications.
+    std::atomic_bool registered{ false };
+    // The snapshot can only be trusted once we are notified about the changes.
+    std::atomic_bool tracking{ false };
+    std::atomic_bool preferDark{ false };
+    std::atomic_bool darkThemeName{ false };
+
+    void refreshPreferDark()
+    {
+        preferDark.store(gtkSettings<bool>(GTK_THEME_PREFER_DARK_PROP), std::memory_order_relaxed);
+    }
+
+    void refreshThemeName()
+    {
+        darkThemeName.store(gtkSettings(GTK_THEME_NAME_PROP).contains(kdark, Qt::CaseInsensitive), std::memory_order_relaxed);
+    }
+};
+
+Q_GLOBAL_STATIC(GtkThemeSettingsData, g_gtkThemeSettingsData)
+
+static inline void notifySystemSettingsChanged(const SystemSettingChanges changes)
+{
+    // Sometimes the FramelessManager instance may be destroyed already.
+    if (FramelessManager * const manager = FramelessManager::instance()) {
+        if (FramelessManagerPrivate * const managerPriv = FramelessManagerPrivate::get(manager)) {
+            managerPriv->notifySystemSettingsChanged(changes);
+        }
+    }
+}
+
+static inline void preferDarkThemeChangeNotificationCallback()
+{
+    g_gtkThemeSettingsData()->refreshPreferDark();
+    notifySystemSettingsChanged(SystemSettingChange::Theme);
+}
+
+static inline void themeNameChangeNotificationCallback()
+{
+    g_gtkThemeSettingsData()->refreshThemeName();
+    notifySystemSettingsChanged(SystemSettingChange::Theme);
+}
+
+static inline bool ensureGtkThemeTracking()
+{
+    GtkThemeSettingsData * const data = g_gtkThemeSettingsData();
+    if (data->registered.exchange(true, std::memory_order_acq_rel)) {
+        // Either done already, or still in progress on another thread.
+        return data->tracking.load(std::memory_order_acquire);
+    }
+    GtkSettings * const settings = gtk_settings_get_default();
+    if (!settings) {
+        WARNING << "Failed to retrieve the GTK settings, the GTK theme settings can't be cached.";
+        return false;
+    }
+    data->refreshPreferDark();
+    data->refreshThemeName();
+    g_signal_connect(settings, "notify::gtk-application-prefer-dark-theme", preferDarkThemeChangeNotificationCallback, nullptr);
+    g_signal_connect(settings, "notify::gtk-theme-name", themeNameChangeNotificationCallback, nullptr);
+    data->tracking.store(true, std::memory_order_release);
+    return true;
+}
+
 [[maybe_unused]] [[nodiscard]] static inline int
     qtEdgesToWmMoveOrResizeOperation(const Qt::Edges edges)
 {
@@ -413,7 +485,13 @@ bool Utils::isTitleBarColorized()
 
 QColor Utils::getAccentColor_linux()
 {
-    // ### TODO
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+    if (const XdgPortalSettings * const portal = XdgPortalSettings::instance()) {
+        if (const std::optional<QColor> color = portal->accentColor()) {
+            return color.value();
+        }
+    }
+#endif // FRAMELESSHELPER_CONFIG(xdg_portal)
     return QGuiApplication::palette().color(QPalette::Highlight);
 }
 
@@ -432,9 +510,43 @@ bool Utils::shouldAppsUseDarkMode_linux()
         it's mainly used for easy debugging, so it should be possible to use it
         to override any other settings.
     */
-    const QString envThemeName = qEnvironmentVariable(GTK_THEME_NAME_ENV_VAR);
-    if (!envThemeName.isEmpty()) {
-        return envThemeName.contains(kdark, Qt::CaseInsensitive);
+    static const auto envThemeName = []() -> std::optional<bool> {
+        const QString name = qEnvironmentVariable(GTK_THEME_NAME_ENV_VAR);
+        if (name.isEmpty()) {
+            return std::nullopt;
+        }
+        return name.contains(kdark, Qt::CaseInsensitive);
+    }();
+    if (envThemeName.has_value()) {
+        return envThemeName.value();
+    }
+
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+    /*
+        https://flatpak.github.io/xdg-desktop-portal/docs/doc-org.freedesktop.portal.Settings.html
+
+        The portal knows the user's preference on both GNOME and KDE, and we don't
+        need to load GTK for it. Only fall back to GTK when it has no opinion.
+    */
+    if (const XdgPortalSettings * const portal = XdgPortalSettings::instance()) {
+        if (const std::optional<bool> dark = portal->shouldAppsUseDarkMode()) {
+            return dark.value();
+        }
+#  if (QT_VERSION >= QT_VERSION_CHECK(6, 4, 0))
+        // Nobody initializes GTK for us since Qt 6.4, so don't touch it as long as the
+        // portal may still answer. We'll be asked again once the portal has replied.
+        if (portal->isPending()) {
+            return false;
+        }
+#  endif
+    }
+#endif // FRAMELESSHELPER_CONFIG(xdg_portal)
+
+    GtkThemeSettingsData * const data = g_gtkThemeSettingsData();
+    if (!ensureGtkThemeTracking()) {
+        // We can't get notified about the GTK setting changes, so we can't cache anything.
+        data->refreshPreferDark();
+        data->refreshThemeName();
     }
 
     /*
@@ -444,20 +556,14 @@ bool Utils::shouldAppsUseDarkMode_linux()
         gtk-theme-name provides both light and dark variants. We can save a
         regex check by testing this property first.
     */
-    const auto preferDark = gtkSettings<bool>(GTK_THEME_PREFER_DARK_PROP);
-    if (preferDark) {
+    if (data->preferDark.load(std::memory_order_relaxed)) {
         return true;
     }
 
     /*
         https://docs.gtk.org/gtk3/property.Settings.gtk-theme-name.html
     */
-    const auto curThemeName = gtkSettings(GTK_THEME_NAME_PROP);
-    if (!curThemeName.isEmpty()) {
-        return curThemeName.contains(kdark, Qt::CaseInsensitive);
-    }
-
-    return false;
+    return data->darkThemeName.load(std::memory_order_relaxed);
 }
 
 bool Utils::setBlurBehindWindowEnabled(const WId windowId, const BlurMode mode, const QColor &color)
@@ -506,6 +612,9 @@ QString Utils::getWallpaperFilePath()
         return {};
     }
     return QUtf8String(rawPath);
+#elif FRAMELESSHELPER_CONFIG(xdg_portal)
+    const XdgPortalSettings * const portal = XdgPortalSettings::instance();
+    return (portal ? portal->wallpaperFilePath().value_or(QString{}) : QString{});
 #else
     // ### TODO
     return {};
@@ -542,6 +651,9 @@ WallpaperAspectStyle Utils::getWallpaperAspectStyle()
             return defaultAspectStyle;
         }
     }
+#elif FRAMELESSHELPER_CONFIG(xdg_portal)
+    const XdgPortalSettings * const portal = XdgPortalSettings::instance();
+    return (portal ? portal->wallpaperAspectStyle().value_or(WallpaperAspectStyle::Fill) : WallpaperAspectStyle::Fill);
 #else
     // ### TODO
     return WallpaperAspectStyle::Fill;
@@ -575,26 +687,40 @@ bool Utils::isBlurBehindWindowSupported()
     return result;
 }
 
-static inline void themeChangeNotificationCallback()
-{
-    // Sometimes the FramelessManager instance may be destroyed already.
-    if (FramelessManager * const manager = FramelessManager::instance()) {
-        if (FramelessManagerPrivate * const managerPriv = FramelessManagerPrivate::get(manager)) {
-            managerPriv->notifySystemThemeHasChangedOrNot();
-        }
-    }
-}
-
 bool Utils::registerThemeChangeNotification()
 {
-    GtkSettings * const settings = gtk_settings_get_default();
-    Q_ASSERT(settings);
-    if (!settings) {
-        return false;
-    }
-    g_signal_connect(settings, "notify::gtk-application-prefer-dark-theme", themeChangeNotificationCallback, nullptr);
-    g_signal_connect(settings, "notify::gtk-theme-name", themeChangeNotificationCallback, nullptr);
-    return true;
+    bool result = false;
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+    // Prefer the XDG desktop portal, it can tell us about the wallpaper changes as well,
+    // and we don't need to drag GTK in at all. The portal reads its settings asynchronously,
+    // so nothing blocks here, everything derived from the fallbacks in the mean time is
+    // refreshed once the settings have arrived.
+    XdgPortalSettings * const portal = XdgPortalSettings::instance();
+    static bool registered = false;
+    if (portal && !registered) {
+        registered = true;
+        QObject::connect(portal, &XdgPortalSettings::settingsLoaded, portal, [](){
+            notifySystemSettingsChanged(SystemSettingChange::Theme | SystemSettingChange::AccentColor | SystemSettingChange::Wallpaper);
+        });
+        QObject::connect(portal, &XdgPortalSettings::colorSchemeChanged, portal, [](){
+            notifySystemSettingsChanged(SystemSettingChange::Theme);
+        });
+        QObject::connect(portal, &XdgPortalSettings::accentColorChanged, portal, [](){
+            notifySystemSettingsChanged(SystemSettingChange::AccentColor);
+        });
+        QObject::connect(portal, &XdgPortalSettings::wallpaperChanged, portal, [](){
+            notifySystemSettingsChanged(SystemSettingChange::Wallpaper);
+        });
+    }
+    result = (portal != nullptr);
+#endif // FRAMELESSHELPER_CONFIG(xdg_portal)
+#if (QT_VERSION < QT_VERSION_CHECK(6, 4, 0))
+    // Qt 6.4 gained the ability to detect the system theme change, and nobody initializes
+    // GTK for us in that case, so only subscribe to the GTK notifications before that.
+    // The theme check still enables it lazily if it ever has to fall back to GTK.
+    result = (ensureGtkThemeTracking() || result);
+#endif
+    return result;
 }
 
 QColor Utils::getFrameBorderColor(const bool active)
@@ -615,6 +741,7 @@ xcb_atom_t Utils::internAtom(const char *name)
         return XCB_NONE;
     }
     const xcb_intern_atom_cookie_t cookie = xcb_intern_atom(connection, false, qstrlen(name), name);
+    FRAMELESSHELPER_PERFORMANCE_COUNT(X11RoundTrips);
     xcb_intern_atom_reply_t * const reply = xcb_intern_atom_reply(connection, cookie, nullptr);
     if (!reply) {
         return XCB_NONE;
@@ -643,6 +770,7 @@ QString Utils::getWindowManagerName()
             return {};
         }
         const xcb_get_property_cookie_t cookie = xcb_get_property_unchecked(connection, false, rootWindow, wmCheckAtom, XCB_ATOM_WINDOW, 0, 1024);
+        FRAMELESSHELPER_PERFORMANCE_COUNT(X11RoundTrips);
         xcb_get_property_reply_t * const reply = xcb_get_property_reply(connection, cookie, nullptr);
         if (!reply) {
             return {};
@@ -667,6 +795,7 @@ QString Utils::getWindowManagerName()
             return {};
         }
         const xcb_get_property_cookie_t wmCookie = xcb_get_property_unchecked(connection, false, windowManager, wmNameAtom, strAtom, 0, 1024);
+        FRAMELESSHELPER_PERFORMANCE_COUNT(X11RoundTrips);
         xcb_get_property_reply_t * const wmReply = xcb_get_property_reply(connection, wmCookie, nullptr);
         if (!wmReply) {
             std::free(reply);
@@ -726,6 +855,13 @@ void Utils::openSystemMenu(const WId windowId, const QPoint &globalPos)
     xcb_flush(connection);
 }
 
+void Utils::x11_flush()
+{
+    if (xcb_connection_t * const connection = x11_connection()) {
+        xcb_flush(connection);
+    }
+}
+
 QByteArray Utils::getWindowProperty(const WId windowId, const xcb_atom_t prop, const xcb_atom_t type, const quint32 data_len)
 {
     Q_ASSERT(windowId);
@@ -740,6 +876,7 @@ QByteArray Utils::getWindowProperty(const WId windowId, const xcb_atom_t prop, c
         return {};
     }
     const xcb_get_property_cookie_t cookie = xcb_get_property(connection, false, windowId, prop, type, 0, data_len);
+    FRAMELESSHELPER_PERFORMANCE_COUNT(X11RoundTrips);
     xcb_get_property_reply_t * const reply = xcb_get_property_reply(connection, cookie, nullptr);
     if (!reply) {
         return {};
@@ -766,7 +903,10 @@ void Utils::setWindowProperty(const WId windowId, const xcb_atom_t prop, const x
         return;
     }
     xcb_change_property(connection, XCB_PROP_MODE_REPLACE, windowId, prop, type, format, data_len, data);
-    xcb_flush(connection);
+    // A registration batch flushes the requests of all its windows at once.
+    if (!FramelessRegistrationBatch::isActive()) {
+        xcb_flush(connection);
+    }
 }
 
 void Utils::clearWindowProperty(const WId windowId, const xcb_atom_t prop)
@@ -816,6 +956,7 @@ bool Utils::isSupportedByWindowManager(const xcb_atom_t atom)
         int remaining = 0;
         do {
             const xcb_get_property_cookie_t cookie = xcb_get_property(connection, false, rootWindow, netSupportedAtom, XCB_ATOM_ATOM, offset, 1024);
+            FRAMELESSHELPER_PERFORMANCE_COUNT(X11RoundTrips);
             xcb_get_property_reply_t * const reply = xcb_get_property_reply(connection, cookie, nullptr);
             if (!reply) {
                 break;
@@ -861,6 +1002,7 @@ bool Utils::isSupportedByRootWindow(const xcb_atom_t atom)
         }
         result_type result = {};
         const xcb_list_properties_cookie_t cookie = xcb_list_properties(connection, rootWindow);
+        FRAMELESSHELPER_PERFORMANCE_COUNT(X11RoundTrips);
         xcb_list_properties_reply_t * const reply = xcb_list_properties_reply(connection, cookie, nullptr);
         if (!reply) {
             return {};
@@ -196,21 +196,21 @@ public:
                 QT_WARNING_DISABLE_DEPRECATED
                 NSAppearance.currentAppearance = NSApp.effectiveAppearance; // FIXME: use latest API.
                 QT_WARNING_POP
-                MacOSThemeObserver::notifySystemThemeChange();
+                MacOSThemeObserver::notifySystemThemeChange(SystemSettingChange::Theme | SystemSettingChange::AccentColor);
             });
         }
         m_systemColorObserver = std::make_unique<MacOSNotificationObserver>(nil, NSSystemColorsDidChangeNotification,
-            [](){ MacOSThemeObserver::notifySystemThemeChange(); });
+            [](){ MacOSThemeObserver::notifySystemThemeChange(SystemSettingChange::AccentColor); });
     }
 
     ~MacOSThemeObserver() = default;
 
-    static void notifySystemThemeChange()
+    static void notifySystemThemeChange(const SystemSettingChanges changes)
     {
         // Sometimes the FramelessManager instance may be destroyed already.
         if (FramelessManager * const manager = FramelessManager::instance()) {
             if (FramelessManagerPrivate * const managerPriv = FramelessManagerPrivate::get(manager)) {
-                managerPriv->notifySystemThemeHasChangedOrNot();
+                managerPriv->notifySystemSettingsChanged(changes);
             }
         }
     }
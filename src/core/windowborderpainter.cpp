@@ -83,11 +83,37 @@ const WindowBorderPainterPrivate *WindowBorderPainterPrivate::get(const WindowBo
     return q->d_func();
 }
 
+const WindowBorderPainterPrivate::PaintCache &WindowBorderPainterPrivate::getPaintCache(const bool active)
+{
+    std::optional<PaintCache> &cache = paintCache.at(active ? 1 : 0);
+    if (cache.has_value()) {
+        return cache.value();
+    }
+    Q_Q(const WindowBorderPainter);
+    QColor color = (active ? q->activeColor() : q->inactiveColor());
+    if (!color.isValid()) {
+        color = (active ? kDefaultBlackColor : kDefaultDarkGrayColor);
+    }
+    // A zero width pen used to give us a cosmetic one pixel wide line.
+    cache = PaintCache{ color, std::max(q->thickness(), 1), q->edges() };
+    return cache.value();
+}
+
+void WindowBorderPainterPrivate::invalidatePaintCache()
+{
+    paintCache = {};
+}
+
 WindowBorderPainter::WindowBorderPainter(QObject *parent)
     : QObject(parent), d_ptr(std::make_unique<WindowBorderPainterPrivate>(this))
 {
-    connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged, this, &WindowBorderPainter::nativeBorderChanged);
+    FramelessManager * const manager = FramelessManager::instance();
+    connect(manager, &FramelessManager::systemColorSchemeChanged, this, &WindowBorderPainter::nativeBorderChanged);
+    connect(manager, &FramelessManager::systemAccentColorChanged, this, &WindowBorderPainter::nativeBorderChanged);
+    connect(manager, &FramelessManager::systemColorizationAreaChanged, this, &WindowBorderPainter::nativeBorderChanged);
     connect(this, &WindowBorderPainter::nativeBorderChanged, this, &WindowBorderPainter::shouldRepaint);
+    // Everything that affects the cached colors and geometry also triggers a repaint.
+    connect(this, &WindowBorderPainter::shouldRepaint, d_ptr.get(), &WindowBorderPainterPrivate::invalidatePaintCache);
 }
 
 WindowBorderPainter::~WindowBorderPainter() = default;
@@ -155,51 +181,36 @@ void WindowBorderPainter::paint(QPainter *painter, const QSize &size, const bool
         return;
     }
     Q_D(WindowBorderPainter);
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    QList<QLineF> lines = {};
-#else
-    QVector<QLineF> lines = {};
-#endif
-    static constexpr const auto gap = qreal(0.5);
-    const auto leftTop = QPointF{ gap, gap };
-    const auto rightTop = QPointF{ qreal(size.width()) - gap, leftTop.y() };
-    const auto rightBottom = QPointF{ rightTop.x(), qreal(size.height()) - gap };
-    const auto leftBottom = QPointF{ leftTop.x(), rightBottom.y() };
-    const WindowEdges edges = d->edges.value_or(nativeEdges());
-    if (edges & WindowEdge::Left) {
-        lines.append({leftBottom, leftTop});
-    }
-    if (edges & WindowEdge::Top) {
-        lines.append({leftTop, rightTop});
-    }
-    if (edges & WindowEdge::Right) {
-        lines.append({rightTop, rightBottom});
+    const WindowBorderPainterPrivate::PaintCache &cache = d->getPaintCache(active);
+    if (!cache.edges) {
+        return;
     }
-    if (edges & WindowEdge::Bottom) {
-        lines.append({rightBottom, leftBottom});
+    // The border is made of solid axis aligned strips, plain fills are enough and
+    // much cheaper than stroking antialiased lines. The vertical strips don't
+    // overlap the horizontal ones so translucent colors stay uniform at the corners.
+    const int width = size.width();
+    const int height = size.height();
+    const int thickness = std::min(cache.thickness, std::min(width, height));
+    const int top = ((cache.edges & WindowEdge::Top) ? thickness : 0);
+    const int bottom = ((cache.edges & WindowEdge::Bottom) ? thickness : 0);
+    const bool antialiasing = painter->testRenderHint(QPainter::Antialiasing);
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    if (top > 0) {
+        painter->fillRect(QRect(0, 0, width, top), cache.color);
     }
-    if (lines.isEmpty()) {
-        return;
+    if (bottom > 0) {
+        painter->fillRect(QRect(0, height - bottom, width, bottom), cache.color);
     }
-    painter->save();
-    painter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
-    QPen pen = {};
-    pen.setColor([this, d, active]() -> QColor {
-        QColor color = {};
-        if (active) {
-            color = d->activeColor.value_or(nativeActiveColor());
-        } else {
-            color = d->inactiveColor.value_or(nativeInactiveColor());
+    const int sideHeight = (height - top - bottom);
+    if (sideHeight > 0) {
+        if (cache.edges & WindowEdge::Left) {
+            painter->fillRect(QRect(0, top, thickness, sideHeight), cache.color);
         }
-        if (color.isValid()) {
-            return color;
+        if (cache.edges & WindowEdge::Right) {
+            painter->fillRect(QRect(width - thickness, top, thickness, sideHeight), cache.color);
         }
-        return (active ? kDefaultBlackColor : kDefaultDarkGrayColor);
-    }());
-    pen.setWidth(d->thickness.value_or(nativeThickness()));
-    painter->setPen(pen);
-    painter->drawLines(lines);
-    painter->restore();
+    }
+    painter->setRenderHint(QPainter::Antialiasing, antialiasing);
 }
 
 void WindowBorderPainter::setThickness(const int value)
@@ -0,0 +1,133 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "windowreadinesswatcher_p.h"
+#include <QtCore/qcoreevent.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qtimer.h>
+#include <QtGui/qwindow.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcWindowReadinessWatcher, "wangwenx190.framelesshelper.core.windowreadinesswatcher")
+#  define INFO qCInfo(lcWindowReadinessWatcher)
+#  define DEBUG qCDebug(lcWindowReadinessWatcher)
+#  define WARNING qCWarning(lcWindowReadinessWatcher)
+#  define CRITICAL qCCritical(lcWindowReadinessWatcher)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+// Windows which are shown but never get exposed (minimized, on another virtual
+// desktop, some Wayland compositors, ...) must not stay "not ready" forever.
+static constexpr const int kExposeTimeout = 500; // ms
+
+WindowReadinessWatcher::WindowReadinessWatcher(QWindow *window, const Callback &callback, QObject *parent)
+    : QObject(parent), m_window(window), m_callback(callback)
+{
+}
+
+WindowReadinessWatcher::~WindowReadinessWatcher()
+{
+    if (m_window) {
+        m_window->removeEventFilter(this);
+    }
+}
+
+void WindowReadinessWatcher::watch(QWindow *window, QObject *context, const Callback &callback)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(context);
+    Q_ASSERT(callback);
+    if (!window || !context || !callback) {
+        return;
+    }
+    // Owned by the context, so the callback won't run once the context is gone.
+    const auto watcher = new WindowReadinessWatcher(window, callback, context);
+    if (!window->handle()) {
+        // The QPA plugin creates and initializes the platform window synchronously.
+        window->create();
+    }
+    // Only the events posted while creating the platform window (initial geometry,
+    // screen and DPI changes) still need to be delivered before we can go on. We
+    // are usually attached before the window is shown, and show() is typically
+    // called right after that, so only decide what to wait for once they have been.
+    QTimer::singleShot(0, watcher, [watcher](){ watcher->check(); });
+}
+
+void WindowReadinessWatcher::check()
+{
+    if (m_finished || m_waitingForExpose) {
+        return;
+    }
+    if (!m_window || !m_window->isVisible() || m_window->isExposed()) {
+        finish();
+        return;
+    }
+    // The window is being mapped right now. On X11 the first expose event is
+    // only delivered after the MapNotify and the ConfigureNotify events of the
+    // initial mapping, that is, once the window manager has placed the window.
+    m_waitingForExpose = true;
+    m_window->installEventFilter(this);
+    QTimer::singleShot(kExposeTimeout, this, [this](){
+        DEBUG << "The window has not been exposed in time, considering it ready anyway.";
+        finish();
+    });
+}
+
+bool WindowReadinessWatcher::eventFilter(QObject *object, QEvent *event)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(event);
+    if (!object || !event) {
+        return false;
+    }
+    if ((object == m_window) && (event->type() == QEvent::Expose) && m_window->isExposed()) {
+        // Let the window handle the expose event first, we are only observing here.
+        QTimer::singleShot(0, this, [this](){ finish(); });
+    }
+    return QObject::eventFilter(object, event);
+}
+
+void WindowReadinessWatcher::finish()
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    if (m_window) {
+        m_window->removeEventFilter(this);
+    }
+    const Callback callback = std::exchange(m_callback, nullptr);
+    deleteLater();
+    callback();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
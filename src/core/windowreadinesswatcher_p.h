@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/windowreadinesswatcher_p.h"
@@ -0,0 +1,386 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "xdgportalsettings_p.h"
+
+#if FRAMELESSHELPER_CONFIG(xdg_portal)
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qurl.h>
+#include <QtDBus/qdbusargument.h>
+#include <QtDBus/qdbusconnection.h>
+#include <QtDBus/qdbuserror.h>
+#include <QtDBus/qdbusmessage.h>
+#include <QtDBus/qdbuspendingcall.h>
+#include <utility>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcXdgPortalSettings, "wangwenx190.framelesshelper.core.xdgportalsettings")
+#  define INFO qCInfo(lcXdgPortalSettings)
+#  define DEBUG qCDebug(lcXdgPortalSettings)
+#  define WARNING qCWarning(lcXdgPortalSettings)
+#  define CRITICAL qCCritical(lcXdgPortalSettings)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+FRAMELESSHELPER_STRING_CONSTANT2(PortalService, "org.freedesktop.portal.Desktop")
+FRAMELESSHELPER_STRING_CONSTANT2(PortalPath, "/org/freedesktop/portal/desktop")
+FRAMELESSHELPER_STRING_CONSTANT2(PortalSettingsInterface, "org.freedesktop.portal.Settings")
+FRAMELESSHELPER_STRING_CONSTANT(ReadAll)
+FRAMELESSHELPER_STRING_CONSTANT(SettingChanged)
+
+// https://flatpak.github.io/xdg-desktop-portal/docs/doc-org.freedesktop.portal.Settings.html
+FRAMELESSHELPER_STRING_CONSTANT2(AppearanceGroup, "org.freedesktop.appearance")
+FRAMELESSHELPER_STRING_CONSTANT2(ColorSchemeKey, "color-scheme")
+FRAMELESSHELPER_STRING_CONSTANT2(AccentColorKey, "accent-color")
+
+// GNOME forwards its GSettings schemas through the portal as well.
+FRAMELESSHELPER_STRING_CONSTANT2(GnomeBackgroundGroup, "org.gnome.desktop.background")
+FRAMELESSHELPER_STRING_CONSTANT2(PictureUriKey, "picture-uri")
+FRAMELESSHELPER_STRING_CONSTANT2(PictureUriDarkKey, "picture-uri-dark")
+FRAMELESSHELPER_STRING_CONSTANT2(PictureOptionsKey, "picture-options")
+
+FRAMELESSHELPER_STRING_CONSTANT2(wallpaper, "wallpaper")
+FRAMELESSHELPER_STRING_CONSTANT2(centered, "centered")
+FRAMELESSHELPER_STRING_CONSTANT2(scaled, "scaled")
+FRAMELESSHELPER_STRING_CONSTANT2(stretched, "stretched")
+FRAMELESSHELPER_STRING_CONSTANT2(spanned, "spanned")
+
+static constexpr const quint32 kColorSchemePreferDark = 1;
+static constexpr const quint32 kColorSchemePreferLight = 2;
+
+[[nodiscard]] static inline QVariant unwrapVariant(const QVariant &value)
+{
+    // Some old portal implementations wrap the value into another variant.
+    if (value.userType() == qMetaTypeId<QDBusVariant>()) {
+        return unwrapVariant(qvariant_cast<QDBusVariant>(value).variant());
+    }
+    return value;
+}
+
+[[nodiscard]] static inline std::optional<bool> colorSchemeToDarkMode(const std::optional<quint32> &colorScheme)
+{
+    if (!colorScheme.has_value()) {
+        return std::nullopt;
+    }
+    switch (colorScheme.value()) {
+    case kColorSchemePreferDark:
+        return true;
+    case kColorSchemePreferLight:
+        return false;
+    default:
+        return std::nullopt;
+    }
+}
+
+[[nodiscard]] static inline QString settingId(const QString &group, const QString &key)
+{
+    return (group + u'/' + key);
+}
+
+[[nodiscard]] static inline std::optional<QColor> toAccentColor(const QVariant &value)
+{
+    if (value.userType() != qMetaTypeId<QDBusArgument>()) {
+        return std::nullopt;
+    }
+    const auto argument = qvariant_cast<QDBusArgument>(value);
+    double red = -1.0;
+    double green = -1.0;
+    double blue = -1.0;
+    argument.beginStructure();
+    argument >> red >> green >> blue;
+    argument.endStructure();
+    // Out of range values mean the user didn't choose any accent color.
+    const auto valid = [](const double channel) -> bool { return ((channel >= 0.0) && (channel <= 1.0)); };
+    if (!valid(red) || !valid(green) || !valid(blue)) {
+        return std::nullopt;
+    }
+    return QColor::fromRgbF(red, green, blue);
+}
+
+struct XdgPortalSettingsData
+{
+    QMutex mutex;
+    XdgPortalSettings *instance = nullptr;
+};
+
+Q_GLOBAL_STATIC(XdgPortalSettingsData, g_xdgPortalSettingsData)
+
+XdgPortalSettings::XdgPortalSettings(QObject *parent) : QObject(parent)
+{
+    // instance() may be called for the first time from the wallpaper thread, which has no
+    // event loop, but the D-Bus replies and signals have to be delivered to us.
+    const QCoreApplication * const app = QCoreApplication::instance();
+    Q_ASSERT(app);
+    if (thread() == app->thread()) {
+        connectToPortal();
+    } else {
+        moveToThread(app->thread());
+        QMetaObject::invokeMethod(this, &XdgPortalSettings::connectToPortal, Qt::QueuedConnection);
+    }
+}
+
+XdgPortalSettings::~XdgPortalSettings() = default;
+
+XdgPortalSettings *XdgPortalSettings::instance()
+{
+    if (!QCoreApplication::instance()) {
+        return nullptr;
+    }
+    XdgPortalSettingsData * const data = g_xdgPortalSettingsData();
+    const QMutexLocker locker(&data->mutex);
+    if (!data->instance) {
+        data->instance = new XdgPortalSettings;
+        qAddPostRoutine(destroyInstance);
+    }
+    return data->instance;
+}
+
+void XdgPortalSettings::destroyInstance()
+{
+    // Runs from the QCoreApplication destructor, while the event dispatcher is still there.
+    XdgPortalSettingsData * const data = g_xdgPortalSettingsData();
+    const QMutexLocker locker(&data->mutex);
+    delete std::exchange(data->instance, nullptr);
+}
+
+void XdgPortalSettings::connectToPortal()
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    if (!bus.isConnected()) {
+        WARNING << "Failed to connect to the D-Bus session bus:" << bus.lastError().message();
+        {
+            const QMutexLocker locker(&m_mutex);
+            m_pending = false;
+        }
+        Q_EMIT settingsLoaded();
+        return;
+    }
+    if (!bus.connect(kPortalService, kPortalPath, kPortalSettingsInterface, kSettingChanged,
+            this, SLOT(onSettingChanged(QString, QString, QDBusVariant)))) {
+        WARNING << "Failed to subscribe to the SettingChanged signal of the XDG desktop portal.";
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(kPortalService, kPortalPath, kPortalSettingsInterface, kReadAll);
+    message << QStringList{ kAppearanceGroup, kGnomeBackgroundGroup };
+    // Never block on the bus, the settings are applied once the reply arrives.
+    const auto watcher = new QDBusPendingCallWatcher(bus.asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &XdgPortalSettings::onReadAllFinished);
+}
+
+bool XdgPortalSettings::isAvailable() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_available;
+}
+
+bool XdgPortalSettings::isPending() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_pending;
+}
+
+std::optional<bool> XdgPortalSettings::shouldAppsUseDarkMode() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return colorSchemeToDarkMode(m_settings.colorScheme);
+}
+
+std::optional<QColor> XdgPortalSettings::accentColor() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_settings.accentColor;
+}
+
+std::optional<QString> XdgPortalSettings::wallpaperFilePath() const
+{
+    QString uri = {};
+    {
+        const QMutexLocker locker(&m_mutex);
+        uri = m_settings.pictureUri;
+        if (!m_settings.pictureUriDark.isEmpty() && colorSchemeToDarkMode(m_settings.colorScheme).value_or(false)) {
+            uri = m_settings.pictureUriDark;
+        }
+    }
+    if (uri.isEmpty()) {
+        return std::nullopt;
+    }
+    const QUrl url(uri);
+    return (url.isLocalFile() ? url.toLocalFile() : uri);
+}
+
+std::optional<WallpaperAspectStyle> XdgPortalSettings::wallpaperAspectStyle() const
+{
+    QString options = {};
+    {
+        const QMutexLocker locker(&m_mutex);
+        options = m_settings.pictureOptions;
+    }
+    if (options.isEmpty()) {
+        return std::nullopt;
+    }
+    if (options == kwallpaper) {
+        return WallpaperAspectStyle::Tile;
+    } else if (options == kcentered) {
+        return WallpaperAspectStyle::Center;
+    } else if (options == kscaled) {
+        return WallpaperAspectStyle::Fit;
+    } else if (options == kstretched) {
+        return WallpaperAspectStyle::Stretch;
+    } else if (options == kspanned) {
+        return WallpaperAspectStyle::Span;
+    } else {
+        // "zoom" and "none".
+        return WallpaperAspectStyle::Fill;
+    }
+}
+
+void XdgPortalSettings::onReadAllFinished(QDBusPendingCallWatcher *watcher)
+{
+    Q_ASSERT(watcher);
+    if (!watcher) {
+        return;
+    }
+    watcher->deleteLater();
+    {
+        const QMutexLocker locker(&m_mutex);
+        m_pending = false;
+    }
+    const QDBusMessage reply = watcher->reply();
+    if (reply.type() != QDBusMessage::ReplyMessage) {
+        DEBUG << "The XDG desktop portal settings are not available:" << reply.errorMessage();
+        // Let the users fall back to something else now.
+        Q_EMIT settingsLoaded();
+        return;
+    }
+    const QVariantList arguments = reply.arguments();
+    if (arguments.isEmpty() || (arguments.constFirst().userType() != qMetaTypeId<QDBusArgument>())) {
+        WARNING << "Unexpected reply from the XDG desktop portal:" << reply.signature();
+        Q_EMIT settingsLoaded();
+        return;
+    }
+    {
+        const QMutexLocker locker(&m_mutex);
+        // a{sa{sv}}
+        const auto groups = qvariant_cast<QDBusArgument>(arguments.constFirst());
+        groups.beginMap();
+        while (!groups.atEnd()) {
+            QString group = {};
+            QVariantMap values = {};
+            groups.beginMapEntry();
+            groups >> group >> values;
+            groups.endMapEntry();
+            for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+                if (m_changedBeforeLoaded.contains(settingId(group, it.key()))) {
+                    continue;
+                }
+                std::ignore = updateSetting(group, it.key(), it.value());
+            }
+        }
+        groups.endMap();
+        m_changedBeforeLoaded.clear();
+        m_available = true;
+        m_loaded = true;
+    }
+    DEBUG << "The XDG desktop portal settings have been loaded.";
+    Q_EMIT settingsLoaded();
+}
+
+bool XdgPortalSettings::updateSetting(const QString &group, const QString &key, const QVariant &value)
+{
+    const QVariant data = unwrapVariant(value);
+    if (group == kAppearanceGroup) {
+        if (key == kColorSchemeKey) {
+            const std::optional<quint32> colorScheme = data.toUInt();
+            const bool changed = (m_settings.colorScheme != colorScheme);
+            m_settings.colorScheme = colorScheme;
+            return changed;
+        }
+        if (key == kAccentColorKey) {
+            const std::optional<QColor> accentColor = toAccentColor(data);
+            const bool changed = (m_settings.accentColor != accentColor);
+            m_settings.accentColor = accentColor;
+            return changed;
+        }
+    } else if (group == kGnomeBackgroundGroup) {
+        QString *setting = nullptr;
+        if (key == kPictureUriKey) {
+            setting = &m_settings.pictureUri;
+        } else if (key == kPictureUriDarkKey) {
+            setting = &m_settings.pictureUriDark;
+        } else if (key == kPictureOptionsKey) {
+            setting = &m_settings.pictureOptions;
+        }
+        if (setting) {
+            const QString newValue = data.toString();
+            const bool changed = (*setting != newValue);
+            *setting = newValue;
+            return changed;
+        }
+    }
+    return false;
+}
+
+void XdgPortalSettings::onSettingChanged(const QString &group, const QString &key, const QDBusVariant &value)
+{
+    bool hasDarkWallpaper = false;
+    {
+        const QMutexLocker locker(&m_mutex);
+        m_available = true;
+        if (!m_loaded) {
+            // Don't let the (older) initial snapshot override this value later.
+            m_changedBeforeLoaded.insert(settingId(group, key));
+        }
+        if (!updateSetting(group, key, value.variant())) {
+            return;
+        }
+        hasDarkWallpaper = !m_settings.pictureUriDark.isEmpty();
+    }
+    DEBUG << "XDG desktop portal setting changed:" << group << key;
+    if (group == kGnomeBackgroundGroup) {
+        Q_EMIT wallpaperChanged();
+    } else if (key == kColorSchemeKey) {
+        Q_EMIT colorSchemeChanged();
+        // The dark variant of the wallpaper may be in use now.
+        if (hasDarkWallpaper) {
+            Q_EMIT wallpaperChanged();
+        }
+    } else {
+        Q_EMIT accentColorChanged();
+    }
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif // FRAMELESSHELPER_CONFIG(xdg_portal)
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/xdgportalsettings_p.h"
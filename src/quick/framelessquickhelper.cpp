@@ -35,6 +35,8 @@
 #include <FramelessHelper/Core/private/framelessmanager_p.h>
 #include <FramelessHelper/Core/private/framelessconfig_p.h>
 #include <FramelessHelper/Core/private/framelesshelpercore_global_p.h>
+#include <FramelessHelper/Core/private/windowreadinesswatcher_p.h>
+#include <FramelessHelper/Core/private/performancecounters_p.h>
 #ifdef Q_OS_WINDOWS
 #  include <FramelessHelper/Core/private/winverhelper_p.h>
 #endif // Q_OS_WINDOWS
@@ -72,8 +74,6 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
-static constexpr const auto kRepaintTimerInterval = 300;
-
 struct FramelessQuickHelperExtraData : public FramelessExtraData
 {
     QPointer<QQuickItem> titleBarItem = nullptr;
@@ -139,7 +139,6 @@ FramelessQuickHelperPrivate::FramelessQuickHelperPrivate(FramelessQuickHelper *q
     }
     q_ptr = q;
     repaintTimer.setTimerType(Qt::VeryCoarseTimer);
-    repaintTimer.setInterval(kRepaintTimerInterval);
     connect(&repaintTimer, &QTimer::timeout, this, &FramelessQuickHelperPrivate::doRepaintAllChildren);
     // Workaround a MOC limitation: we can't emit a signal from the parent class.
     connect(q_ptr, &FramelessQuickHelper::windowChanged, q_ptr, &FramelessQuickHelper::windowChanged2);
@@ -176,6 +175,12 @@ void FramelessQuickHelperPrivate::attach()
     if (!window) {
         return;
     }
+    // Start with the right flags when the platform window doesn't exist yet, so that
+    // it doesn't need to be updated right after being created.
+    if (!window->handle() && FramelessManagerPrivate::shouldApplyFramelessWindowHint()
+        && !(window->flags() & Qt::FramelessWindowHint)) {
+        window->setFlags(window->flags() | Qt::FramelessWindowHint);
+    }
     const WId windowId = window->winId();
 
     const FramelessDataPtr data = FramelessManagerPrivate::createData(window, windowId);
@@ -228,23 +233,33 @@ void FramelessQuickHelperPrivate::attach()
 
     std::ignore = FramelessManager::instance()->addWindow(window, windowId);
 
-    // We have to wait for a little time before moving the top level window
-    // , because the platform window may not finish initializing by the time
-    // we reach here, and all the modifications from the Qt side will be lost
-    // due to QPA will reset the position and size of the window during it's
-    // initialization process.
-    QTimer::singleShot(qpaWaitTime, this, [this, q](){
-        qpaReady = true;
-        if (FramelessConfig::instance()->isSet(Option::CenterWindowBeforeShow)) {
-            q->moveWindowToDesktopCenter();
-        }
-        if (FramelessConfig::instance()->isSet(Option::EnableBlurBehindWindow)) {
-            q->setBlurBehindWindowEnabled(true);
+    // All the modifications from the Qt side will be lost if we apply them before the
+    // platform window finishes its initialization, because the QPA plugin will reset
+    // the position and size of the window during that process. So wait until it's
+    // really ready instead of guessing how long that may take.
+    WindowReadinessWatcher::watch(window, this, [this](){
+        // An explicitly requested extra delay is still honored.
+        if (qpaWaitTime > 0) {
+            QTimer::singleShot(qpaWaitTime, this, [this](){ markReady(); });
+        } else {
+            markReady();
         }
-        emitSignalForAllInstances("ready");
     });
 }
 
+void FramelessQuickHelperPrivate::markReady()
+{
+    Q_Q(FramelessQuickHelper);
+    qpaReady = true;
+    if (FramelessConfig::instance()->isSet(Option::CenterWindowBeforeShow)) {
+        q->moveWindowToDesktopCenter();
+    }
+    if (FramelessConfig::instance()->isSet(Option::EnableBlurBehindWindow)) {
+        q->setBlurBehindWindowEnabled(true);
+    }
+    emitSignalForAllInstances("ready");
+}
+
 void FramelessQuickHelperPrivate::detach()
 {
     Q_Q(FramelessQuickHelper);
@@ -408,11 +423,13 @@ FramelessQuickHelper *FramelessQuickHelperPrivate::findOrCreateFramelessHelper(Q
 
 void FramelessQuickHelperPrivate::repaintAllChildren()
 {
-    repaintTimer.start();
+    // Read the delay every time, it can be changed at runtime.
+    repaintTimer.start(FramelessConfig::instance()->duration(ConfigValue::RepaintDelay));
 }
 
 void FramelessQuickHelperPrivate::doRepaintAllChildren()
 {
+    FRAMELESSHELPER_PERFORMANCE_TIME_SCOPE(RepaintAllChildren);
     repaintTimer.stop();
     Q_Q(const FramelessQuickHelper);
     QQuickWindow *window = q->window();
@@ -428,6 +445,7 @@ void FramelessQuickHelperPrivate::doRepaintAllChildren()
     if (!window->isVisible()) {
         return;
     }
+    FRAMELESSHELPER_PERFORMANCE_COUNT(ForcedRepaints);
     if (!((window->windowState() & (Qt::WindowMinimized | Qt::WindowMaximized | Qt::WindowFullScreen)) || q->isWindowFixedSize())) {
         const QSize originalSize = window->size();
         static constexpr const auto margins = QMargins{ 1, 1, 1, 1 };
@@ -478,6 +496,7 @@ QRect FramelessQuickHelperPrivate::mapItemGeometryToScene(const QQuickItem * con
 
 bool FramelessQuickHelperPrivate::isInSystemButtons(const QPoint &pos, QuickGlobal::SystemButtonType *button) const
 {
+    FRAMELESSHELPER_PERFORMANCE_COUNT(HitTests);
     Q_ASSERT(button);
     if (!button) {
         return false;
@@ -528,6 +547,8 @@ bool FramelessQuickHelperPrivate::isInSystemButtons(const QPoint &pos, QuickGlob
 
 bool FramelessQuickHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos) const
 {
+    FRAMELESSHELPER_PERFORMANCE_COUNT(HitTests);
+    FRAMELESSHELPER_PERFORMANCE_TIME_SCOPE(TitleBarHitTest);
     Q_Q(const FramelessQuickHelper);
     const QQuickWindow * const window = q->window();
     if (!window) {
@@ -1013,6 +1034,24 @@ bool FramelessQuickHelper::isReady() const
     return d->qpaReady;
 }
 
+void FramelessQuickHelper::callWhenReady(QObject *context, const std::function<void()> &callback)
+{
+    Q_ASSERT(callback);
+    if (!callback) {
+        return;
+    }
+    Q_D(FramelessQuickHelper);
+    if (d->qpaReady) {
+        callback();
+        return;
+    }
+    const auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(this, &FramelessQuickHelper::ready, (context ? context : this), [connection, callback](){
+        QObject::disconnect(*connection);
+        callback();
+    });
+}
+
 void FramelessQuickHelper::waitForReady()
 {
     Q_D(FramelessQuickHelper);
@@ -49,11 +49,10 @@ using namespace Global;
 
 FramelessQuickUtils::FramelessQuickUtils(QObject *parent) : QObject(parent)
 {
-    connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged, this, [this](){
-        Q_EMIT systemThemeChanged();
-        Q_EMIT systemAccentColorChanged();
-        Q_EMIT titleBarColorizedChanged();
-    });
+    FramelessManager * const manager = FramelessManager::instance();
+    connect(manager, &FramelessManager::systemColorSchemeChanged, this, &FramelessQuickUtils::systemThemeChanged);
+    connect(manager, &FramelessManager::systemAccentColorChanged, this, &FramelessQuickUtils::systemAccentColorChanged);
+    connect(manager, &FramelessManager::systemColorizationAreaChanged, this, &FramelessQuickUtils::titleBarColorizedChanged);
 }
 
 FramelessQuickUtils::~FramelessQuickUtils() = default;
@@ -24,10 +24,14 @@
 
 #include "quickimageitem_p.h"
 #include <QtCore/qloggingcategory.h>
-#include <QtGui/qpainter.h>
-#include <QtGui/qimage.h>
+#include <QtCore/qmutex.h>
+#if QT_CONFIG(thread)
+#  include <QtCore/qrunnable.h>
+#  include <QtCore/qthreadpool.h>
+#endif
 #include <QtGui/qpixmap.h>
-#include <QtGui/qicon.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgimagenode.h>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -51,49 +55,93 @@ FRAMELESSHELPER_STRING_CONSTANT2(FileSystemPrefix, ":")
 FRAMELESSHELPER_STRING_CONSTANT2(UrlPrefix, ":///")
 FRAMELESSHELPER_STRING_CONSTANT2(FilePathPrefix, ":/")
 
-QuickImageItem::QuickImageItem(QQuickItem *parent) : QQuickPaintedItem(parent)
+struct QuickImageItemLoadGuard
 {
-    setAntialiasing(true);
-    setSmooth(true);
-    setMipmap(true);
-    setClip(true);
-}
+    QMutex mutex;
+    QuickImageItem *item = nullptr;
+};
 
-QuickImageItem::~QuickImageItem() = default;
+[[nodiscard]] static inline QString sourceToFilePath(const QString &value)
+{
+    // For most Qt classes, the "qrc:///" prefix won't be recognized as a valid
+    // file system path, unless it accepts a QUrl object. For QString constructors
+    // we can only use ":/" to represent the file system path.
+    QString path = value;
+    if (path.startsWith(kQrcPrefix, Qt::CaseInsensitive)) {
+        path.replace(kQrcPrefix, kFileSystemPrefix, Qt::CaseInsensitive);
+    }
+    if (path.startsWith(kUrlPrefix, Qt::CaseInsensitive)) {
+        path.replace(kUrlPrefix, kFilePathPrefix, Qt::CaseInsensitive);
+    }
+    return path;
+}
 
-void QuickImageItem::paint(QPainter *painter)
+static inline void deliverLoadedImage(const std::shared_ptr<QuickImageItemLoadGuard> &guard,
+    const QString &filePath, const int loadId)
 {
-    Q_ASSERT(painter);
-    if (!painter) {
+    Q_ASSERT(guard);
+    if (!guard) {
         return;
     }
-    if (!m_source.isValid() || m_source.isNull()) {
+    // QImage (unlike QPixmap) can be safely used outside of the GUI thread.
+    const QImage image(filePath);
+    if (image.isNull()) {
+        WARNING << "Failed to load image:" << filePath;
+    }
+    // The item resets the pointer in its destructor while holding the lock,
+    // so it's guaranteed to be alive until the event has been posted. Pending
+    // posted events get discarded automatically when the item is destroyed.
+    const QMutexLocker locker(&guard->mutex);
+    if (!guard->item) {
         return;
     }
-    painter->save();
-    painter->setRenderHints(QPainter::Antialiasing |
-        QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
-    switch (m_source.userType()) {
-    case QMetaType::QUrl:
-        fromUrl(m_source.toUrl(), painter);
-        break;
-    case QMetaType::QString:
-        fromString(m_source.toString(), painter);
-        break;
-    case QMetaType::QImage:
-        fromImage(qvariant_cast<QImage>(m_source), painter);
-        break;
-    case QMetaType::QPixmap:
-        fromPixmap(qvariant_cast<QPixmap>(m_source), painter);
-        break;
-    case QMetaType::QIcon:
-        fromIcon(qvariant_cast<QIcon>(m_source), painter);
-        break;
-    default:
-        WARNING << "Unsupported type:" << m_source.typeName();
-        break;
+    QMetaObject::invokeMethod(guard->item, "handleImageLoaded", Qt::QueuedConnection,
+        Q_ARG(QImage, image), Q_ARG(int, loadId));
+}
+
+#if QT_CONFIG(thread)
+class QuickImageItemLoader : public QRunnable
+{
+    Q_DISABLE_COPY_MOVE(QuickImageItemLoader)
+
+public:
+    explicit QuickImageItemLoader(const std::shared_ptr<QuickImageItemLoadGuard> &guard,
+        const QString &filePath, const int loadId)
+        : m_guard(guard), m_filePath(filePath), m_loadId(loadId)
+    {
+        setAutoDelete(true);
+    }
+
+    ~QuickImageItemLoader() override = default;
+
+    void run() override
+    {
+        deliverLoadedImage(m_guard, m_filePath, m_loadId);
     }
-    painter->restore();
+
+private:
+    std::shared_ptr<QuickImageItemLoadGuard> m_guard = nullptr;
+    QString m_filePath = {};
+    int m_loadId = 0;
+};
+#endif // QT_CONFIG(thread)
+
+QuickImageItem::QuickImageItem(QQuickItem *parent) : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents);
+    setAntialiasing(true);
+    setSmooth(true);
+    setClip(true);
+    m_loadGuard = std::make_shared<QuickImageItemLoadGuard>();
+    m_loadGuard->item = this;
+    connect(this, &QuickImageItem::widthChanged, this, &QuickImageItem::invalidateScaledImage);
+    connect(this, &QuickImageItem::heightChanged, this, &QuickImageItem::invalidateScaledImage);
+}
+
+QuickImageItem::~QuickImageItem()
+{
+    const QMutexLocker locker(&m_loadGuard->mutex);
+    m_loadGuard->item = nullptr;
 }
 
 QVariant QuickImageItem::source() const
@@ -112,72 +160,146 @@ void QuickImageItem::setSource(const QVariant &value)
         return;
     }
     m_source = value;
-    update();
+    loadSource();
     Q_EMIT sourceChanged();
 }
 
-void QuickImageItem::fromUrl(const QUrl &value, QPainter *painter) const
+void QuickImageItem::loadSource()
 {
-    Q_ASSERT(value.isValid());
-    Q_ASSERT(painter);
-    if (!value.isValid() || !painter) {
-        return;
+    // Results of any load that is still in flight are stale from now on.
+    ++m_loadId;
+    m_image = {};
+    m_icon = {};
+    switch (m_source.userType()) {
+    case QMetaType::QUrl: {
+        const QUrl url = m_source.toUrl();
+        if (url.isValid()) {
+            loadFile(url.isLocalFile() ? url.toLocalFile() : url.toString());
+        }
+    } break;
+    case QMetaType::QString:
+        loadFile(m_source.toString());
+        break;
+    case QMetaType::QImage:
+        m_image = qvariant_cast<QImage>(m_source);
+        break;
+    case QMetaType::QPixmap:
+        m_image = qvariant_cast<QPixmap>(m_source).toImage();
+        break;
+    case QMetaType::QIcon:
+        m_icon = qvariant_cast<QIcon>(m_source);
+        break;
+    default:
+        WARNING << "Unsupported type:" << m_source.typeName();
+        break;
     }
-    fromString((value.isLocalFile() ? value.toLocalFile() : value.toString()), painter);
+    invalidateScaledImage();
 }
 
-void QuickImageItem::fromString(const QString &value, QPainter *painter) const
+void QuickImageItem::loadFile(const QString &filePath)
 {
-    Q_ASSERT(!value.isEmpty());
-    Q_ASSERT(painter);
-    if (value.isEmpty() || !painter) {
+    Q_ASSERT(!filePath.isEmpty());
+    if (filePath.isEmpty()) {
         return;
     }
-    return fromPixmap(QPixmap([&value]() -> QString {
-                          // For most Qt classes, the "qrc:///" prefix won't be recognized as a valid
-                          // file system path, unless it accepts a QUrl object. For QString constructors
-                          // we can only use ":/" to represent the file system path.
-                          QString path = value;
-                          if (path.startsWith(kQrcPrefix, Qt::CaseInsensitive)) {
-                              path.replace(kQrcPrefix, kFileSystemPrefix, Qt::CaseInsensitive);
-                          }
-                          if (path.startsWith(kUrlPrefix, Qt::CaseInsensitive)) {
-                              path.replace(kUrlPrefix, kFilePathPrefix, Qt::CaseInsensitive);
-                          }
-                          return path;
-                      }()), painter);
+    const QString path = sourceToFilePath(filePath);
+#if QT_CONFIG(thread)
+    QThreadPool::globalInstance()->start(new QuickImageItemLoader(m_loadGuard, path, m_loadId));
+#else
+    deliverLoadedImage(m_loadGuard, path, m_loadId);
+#endif
 }
 
-void QuickImageItem::fromImage(const QImage &value, QPainter *painter) const
+void QuickImageItem::handleImageLoaded(const QImage &image, const int loadId)
 {
-    Q_ASSERT(!value.isNull());
-    Q_ASSERT(painter);
-    if (value.isNull() || !painter) {
+    if (loadId != m_loadId) {
         return;
     }
-    fromPixmap(QPixmap::fromImage(value), painter);
+    m_image = image;
+    invalidateScaledImage();
 }
 
-void QuickImageItem::fromPixmap(const QPixmap &value, QPainter *painter) const
+void QuickImageItem::invalidateScaledImage()
 {
-    Q_ASSERT(!value.isNull());
-    Q_ASSERT(painter);
-    if (value.isNull() || !painter) {
+    m_scaledImageDirty = true;
+    polish();
+    update();
+}
+
+void QuickImageItem::updatePolish()
+{
+    QQuickItem::updatePolish();
+    if (!m_scaledImageDirty) {
+        return;
+    }
+    QQuickWindow * const win = window();
+    if (!win) {
+        return;
+    }
+    m_scaledImageDirty = false;
+    const qreal dpr = win->effectiveDevicePixelRatio();
+    const QSize logicalSize = paintArea().size().toSize();
+    const QSize pixelSize = (QSizeF(logicalSize) * dpr).toSize();
+    const QImage image = [this, win, dpr, &logicalSize, &pixelSize]() -> QImage {
+        if (pixelSize.isEmpty()) {
+            return {};
+        }
+        if (!m_icon.isNull()) {
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+            Q_UNUSED(win);
+            return m_icon.pixmap(logicalSize, dpr).toImage();
+#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+            Q_UNUSED(dpr);
+            return m_icon.pixmap(win, logicalSize).toImage();
+#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+        }
+        if (m_image.isNull() || (m_image.size() == pixelSize)) {
+            return m_image;
+        }
+        return m_image.scaled(pixelSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }();
+    // Repolishing at the same size (activation changes, hovering, ...) must not
+    // trigger a new texture upload.
+    if (image.cacheKey() == m_scaledImage.cacheKey()) {
         return;
     }
-    const QRectF paintRect = paintArea();
-    const QSize paintSize = paintRect.size().toSize();
-    painter->drawPixmap(paintRect.topLeft(), (value.size() == paintSize ? value : value.scaled(paintSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)));
+    m_scaledImage = image;
+    ++m_scaledImageVersion;
 }
 
-void QuickImageItem::fromIcon(const QIcon &value, QPainter *painter) const
+QSGNode *QuickImageItem::updatePaintNode(QSGNode *old, UpdatePaintNodeData *data)
 {
-    Q_ASSERT(!value.isNull());
-    Q_ASSERT(painter);
-    if (value.isNull() || !painter) {
-        return;
+    Q_UNUSED(data);
+    QQuickWindow * const win = window();
+    const QRectF rect = paintArea();
+    if (!win || rect.isEmpty() || m_scaledImage.isNull()) {
+        delete old;
+        m_textureVersion = 0;
+        return nullptr;
+    }
+    auto node = static_cast<QSGImageNode *>(old);
+    if (!node) {
+        node = win->createImageNode();
+        node->setOwnsTexture(true);
+        node->setFiltering(QSGTexture::Linear);
+        m_textureVersion = 0;
+    }
+    // Only upload a new texture when the rasterized image really changed,
+    // everything else just reuses the existing one.
+    if (m_textureVersion != m_scaledImageVersion) {
+        node->setTexture(win->createTextureFromImage(m_scaledImage));
+        m_textureVersion = m_scaledImageVersion;
+    }
+    node->setRect(rect);
+    return node;
+}
+
+void QuickImageItem::itemChange(const ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+    if ((change == ItemDevicePixelRatioHasChanged) || ((change == ItemSceneChange) && value.window)) {
+        invalidateScaledImage();
     }
-    fromPixmap(value.pixmap(paintArea().size().toSize()), painter);
 }
 
 QRectF QuickImageItem::paintArea() const
@@ -192,12 +314,12 @@ QRectF QuickImageItem::paintArea() const
 
 void QuickImageItem::classBegin()
 {
-    QQuickPaintedItem::classBegin();
+    QQuickItem::classBegin();
 }
 
 void QuickImageItem::componentComplete()
 {
-    QQuickPaintedItem::componentComplete();
+    QQuickItem::componentComplete();
 }
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -265,8 +265,6 @@ void QuickStandardSystemButton::updateColor()
 
 void QuickStandardSystemButton::initialize()
 {
-    FramelessManagerPrivate::initializeIconFont();
-
     setAntialiasing(true);
     setSmooth(true);
     setClip(true);
@@ -79,6 +79,12 @@ void QuickStandardTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
         return;
     }
     m_labelAlignment = value;
+    updateTitleLabelAnchors();
+    Q_EMIT titleLabelAlignmentChanged();
+}
+
+void QuickStandardTitleBar::updateTitleLabelAnchors()
+{
     QQuickAnchors * const labelAnchors = QQuickItemPrivate::get(m_windowTitleLabel)->anchors();
     labelAnchors->resetFill();
     labelAnchors->resetCenterIn();
@@ -93,7 +99,7 @@ void QuickStandardTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
     const QQuickItemPrivate * const titleBarPriv = QQuickItemPrivate::get(this);
     labelAnchors->setVerticalCenter(titleBarPriv->verticalCenter());
     if ((m_labelAlignment & Qt::AlignLeft) || (m_labelAlignment & Qt::AlignRight) || (m_labelAlignment & Qt::AlignHCenter)) {
-        if (m_windowIcon->isVisible()) {
+        if (m_windowIcon && m_windowIcon->isVisible()) {
             labelAnchors->setLeft(QQuickItemPrivate::get(m_windowIcon)->right());
         } else {
             labelAnchors->setLeft(titleBarPriv->left());
@@ -102,7 +108,11 @@ void QuickStandardTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
 #ifdef Q_OS_MACOS
         labelAnchors->setRight(titleBarPriv->right());
 #elif FRAMELESSHELPER_CONFIG(system_button)
-        labelAnchors->setRight(QQuickItemPrivate::get(m_systemButtonsRow)->left());
+        if (m_systemButtonsRow) {
+            labelAnchors->setRight(QQuickItemPrivate::get(m_systemButtonsRow)->left());
+        } else {
+            labelAnchors->setRight(titleBarPriv->right());
+        }
 #endif
         labelAnchors->setRightMargin(kDefaultTitleBarContentsMargin);
         if (m_labelAlignment & Qt::AlignLeft) {
@@ -117,7 +127,6 @@ void QuickStandardTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
         labelAnchors->setLeft(titleBarPriv->left());
         m_windowTitleLabel->setHAlign(QQuickLabel::AlignLeft);
     }
-    Q_EMIT titleLabelAlignmentChanged();
 }
 
 QQuickLabel *QuickStandardTitleBar::titleLabel() const
@@ -128,16 +137,19 @@ QQuickLabel *QuickStandardTitleBar::titleLabel() const
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
 QuickStandardSystemButton *QuickStandardTitleBar::minimizeButton() const
 {
+    const_cast<QuickStandardTitleBar *>(this)->ensureSystemButtons();
     return m_minimizeButton;
 }
 
 QuickStandardSystemButton *QuickStandardTitleBar::maximizeButton() const
 {
+    const_cast<QuickStandardTitleBar *>(this)->ensureSystemButtons();
     return m_maximizeButton;
 }
 
 QuickStandardSystemButton *QuickStandardTitleBar::closeButton() const
 {
+    const_cast<QuickStandardTitleBar *>(this)->ensureSystemButtons();
     return m_closeButton;
 }
 #endif
@@ -178,6 +190,9 @@ QuickChromePalette *QuickStandardTitleBar::chromePalette() const
 
 QSizeF QuickStandardTitleBar::windowIconSize() const
 {
+    if (!m_windowIcon) {
+        return m_windowIconState.size;
+    }
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
     return m_windowIcon->size();
 #else
@@ -194,6 +209,11 @@ void QuickStandardTitleBar::setWindowIconSize(const QSizeF &value)
     if (windowIconSize() == value) {
         return;
     }
+    if (!m_windowIcon) {
+        m_windowIconState.size = value;
+        Q_EMIT windowIconSizeChanged();
+        return;
+    }
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
     m_windowIcon->setSize(value);
 #else
@@ -204,15 +224,23 @@ void QuickStandardTitleBar::setWindowIconSize(const QSizeF &value)
 
 bool QuickStandardTitleBar::windowIconVisible() const
 {
-    return m_windowIcon->isVisible();
+    return (m_windowIcon ? m_windowIcon->isVisible() : m_windowIconState.visible);
 }
 
 void QuickStandardTitleBar::setWindowIconVisible(const bool value)
 {
-    if (m_windowIcon->isVisible() == value) {
+    if (windowIconVisible() == value) {
         return;
     }
-    m_windowIcon->setVisible(value);
+    if (value) {
+        ensureWindowIcon();
+    }
+    if (m_windowIcon) {
+        m_windowIcon->setVisible(value);
+    } else {
+        m_windowIconState.visible = value;
+        Q_EMIT windowIconVisibleChanged();
+    }
 #ifndef Q_OS_MACOS
     if (m_labelAlignment & Qt::AlignLeft) {
         QQuickAnchors * const labelAnchors = QQuickItemPrivate::get(m_windowTitleLabel)->anchors();
@@ -228,7 +256,7 @@ void QuickStandardTitleBar::setWindowIconVisible(const bool value)
 
 QVariant QuickStandardTitleBar::windowIcon() const
 {
-    return m_windowIcon->source();
+    return (m_windowIcon ? m_windowIcon->source() : m_windowIconState.source);
 }
 
 void QuickStandardTitleBar::setWindowIcon(const QVariant &value)
@@ -237,7 +265,12 @@ void QuickStandardTitleBar::setWindowIcon(const QVariant &value)
     if (!value.isValid()) {
         return;
     }
-    if (m_windowIcon->source() == value) {
+    if (windowIcon() == value) {
+        return;
+    }
+    if (!m_windowIcon) {
+        m_windowIconState.source = value;
+        Q_EMIT windowIconChanged();
         return;
     }
     m_windowIcon->setSource(value);
@@ -247,7 +280,7 @@ void QuickStandardTitleBar::updateMaximizeButton()
 {
 #if (FRAMELESSHELPER_CONFIG(system_button) && defined(Q_OS_LINUX))
     const QQuickWindow * const w = window();
-    if (!w) {
+    if (!w || !m_maximizeButton) {
         return;
     }
     const bool max = (w->visibility() == QQuickWindow::Maximized);
@@ -286,7 +319,7 @@ void QuickStandardTitleBar::updateChromeButtonColor()
 {
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
     const QQuickWindow * const w = window();
-    if (!w) {
+    if (!w || !m_minimizeButton) {
         return;
     }
     const QColor activeForeground = m_chromePalette->titleBarActiveForegroundColor();
@@ -362,6 +395,9 @@ void QuickStandardTitleBar::clickCloseButton()
 void QuickStandardTitleBar::retranslateUi()
 {
 #if (FRAMELESSHELPER_CONFIG(system_button) && defined(Q_OS_LINUX))
+    if (!m_minimizeButton) {
+        return;
+    }
     qobject_cast<QQuickToolTipAttached *>(qmlAttachedPropertiesObject<QQuickToolTip>(m_minimizeButton))->setText(tr("Minimize"));
     qobject_cast<QQuickToolTipAttached *>(qmlAttachedPropertiesObject<QQuickToolTip>(m_maximizeButton))->setText([this]() -> QString {
         if (const QQuickWindow * const w = window()) {
@@ -378,14 +414,14 @@ void QuickStandardTitleBar::retranslateUi()
 void QuickStandardTitleBar::updateWindowIcon()
 {
     // The user has set an icon explicitly, don't override it.
-    if (m_windowIcon->source().isValid()) {
+    if (windowIcon().isValid()) {
         return;
     }
     const QIcon icon = (window() ? window()->icon() : QIcon());
     if (icon.isNull()) {
         return;
     }
-    m_windowIcon->setSource(icon);
+    setWindowIcon(icon);
 }
 
 bool QuickStandardTitleBar::mouseEventHandler(QMouseEvent *event)
@@ -466,6 +502,9 @@ QRect QuickStandardTitleBar::windowIconRect() const
     const qreal y = ((height() - size.height()) / qreal(2));
     return QRectF(QPointF(kDefaultTitleBarContentsMargin, y), size).toRect();
 #else
+    if (!m_windowIcon) {
+        return {};
+    }
     return QRectF(QPointF(m_windowIcon->x(), m_windowIcon->y()), windowIconSize()).toRect();
 #endif
 }
@@ -486,33 +525,23 @@ bool QuickStandardTitleBar::isInTitleBarIconArea(const QPoint &pos) const
     return windowIconRect().contains(pos);
 }
 
-void QuickStandardTitleBar::initialize()
+void QuickStandardTitleBar::ensureWindowIcon()
 {
-    setSmooth(true);
-    setClip(true);
-    setAntialiasing(true);
-
-    m_chromePalette = new QuickChromePalette(this);
-    connect(m_chromePalette, &ChromePalette::titleBarColorChanged,
-        this, &QuickStandardTitleBar::updateTitleBarColor);
-    connect(m_chromePalette, &ChromePalette::chromeButtonColorChanged,
-        this, &QuickStandardTitleBar::updateChromeButtonColor);
-
-    QQuickPen * const b = border();
-    b->setWidth(0.0);
-    b->setColor(kDefaultTransparentColor);
-    setHeight(kDefaultTitleBarHeight);
-
-    m_windowTitleLabel = new QQuickLabel(this);
-    m_windowTitleLabel->setMaximumLineCount(1);
-    m_windowTitleLabel->setElideMode(QQuickText::ElideRight);
-    QFont f = m_windowTitleLabel->font();
-    f.setPointSize(kDefaultTitleBarFontPointSize);
-    m_windowTitleLabel->setFont(f);
-
+    if (m_windowIcon) {
+        return;
+    }
     const QQuickItemPrivate * const thisPriv = QQuickItemPrivate::get(this);
-
     m_windowIcon = new QuickImageItem(this);
+    m_windowIcon->setVisible(false);
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+    m_windowIcon->setSize(m_windowIconState.size);
+#else
+    m_windowIcon->setWidth(m_windowIconState.size.width());
+    m_windowIcon->setHeight(m_windowIconState.size.height());
+#endif
+    if (m_windowIconState.source.isValid()) {
+        m_windowIcon->setSource(m_windowIconState.source);
+    }
     QQuickAnchors * const iconAnchors = QQuickItemPrivate::get(m_windowIcon)->anchors();
     iconAnchors->setVerticalCenter(thisPriv->verticalCenter());
 #ifdef Q_OS_MACOS
@@ -527,8 +556,17 @@ void QuickStandardTitleBar::initialize()
     connect(m_windowIcon, &QuickImageItem::sourceChanged, this, &QuickStandardTitleBar::windowIconChanged);
     connect(m_windowIcon, &QuickImageItem::widthChanged, this, &QuickStandardTitleBar::windowIconSizeChanged);
     connect(m_windowIcon, &QuickImageItem::heightChanged, this, &QuickStandardTitleBar::windowIconSizeChanged);
+    m_windowIcon->setVisible(m_windowIconState.visible);
+    m_windowIconState = {};
+}
 
+void QuickStandardTitleBar::ensureSystemButtons()
+{
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+    if (m_systemButtonsRow) {
+        return;
+    }
+    const QQuickItemPrivate * const thisPriv = QQuickItemPrivate::get(this);
     m_systemButtonsRow = new QQuickRow(this);
     QQuickAnchors * const rowAnchors = QQuickItemPrivate::get(m_systemButtonsRow)->anchors();
     rowAnchors->setTop(thisPriv->top());
@@ -539,10 +577,72 @@ void QuickStandardTitleBar::initialize()
     connect(m_maximizeButton, &QuickStandardSystemButton::clicked, this, &QuickStandardTitleBar::clickMaximizeButton);
     m_closeButton = new QuickStandardSystemButton(QuickGlobal::SystemButtonType::Close, m_systemButtonsRow);
     connect(m_closeButton, &QuickStandardSystemButton::clicked, this, &QuickStandardTitleBar::clickCloseButton);
+    updateTitleLabelAnchors();
+    retranslateUi();
+    updateMaximizeButton();
+    updateChromeButtonColor();
+    registerSystemButtons();
 #endif
+}
+
+void QuickStandardTitleBar::registerSystemButtons()
+{
+#if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+    // Without a window we don't know which helper to talk to yet, we'll be called
+    // again once we have been added to one.
+    QQuickWindow * const w = window();
+    if (!m_systemButtonsRow || !w) {
+        return;
+    }
+    // Only talk to a helper that already exists, FramelessQuickHelper::get() would
+    // create one and make the window frameless behind the user's back.
+    FramelessQuickHelper *helper = nullptr;
+    if (QQuickItem * const contentItem = w->contentItem()) {
+        helper = contentItem->findChild<FramelessQuickHelper *>();
+    }
+    if (!helper) {
+        helper = w->findChild<FramelessQuickHelper *>();
+    }
+    if (!helper) {
+        return;
+    }
+    // The helper attaches to the window asynchronously and can't accept the buttons
+    // before that, so wait for it instead of asking users to do this in onReady.
+    helper->callWhenReady(this, [this, helper](){
+        if (!m_systemButtonsRow) {
+            return;
+        }
+        helper->setSystemButton(m_minimizeButton, QuickGlobal::SystemButtonType::Minimize);
+        helper->setSystemButton(m_maximizeButton, QuickGlobal::SystemButtonType::Maximize);
+        helper->setSystemButton(m_closeButton, QuickGlobal::SystemButtonType::Close);
+    });
+#endif
+}
+
+void QuickStandardTitleBar::initialize()
+{
+    setSmooth(true);
+    setClip(true);
+    setAntialiasing(true);
+
+    m_chromePalette = new QuickChromePalette(this);
+    connect(m_chromePalette, &ChromePalette::titleBarColorChanged,
+        this, &QuickStandardTitleBar::updateTitleBarColor);
+    connect(m_chromePalette, &ChromePalette::chromeButtonColorChanged,
+        this, &QuickStandardTitleBar::updateChromeButtonColor);
+
+    QQuickPen * const b = border();
+    b->setWidth(0.0);
+    b->setColor(kDefaultTransparentColor);
+    setHeight(kDefaultTitleBarHeight);
+
+    m_windowTitleLabel = new QQuickLabel(this);
+    m_windowTitleLabel->setMaximumLineCount(1);
+    m_windowTitleLabel->setElideMode(QQuickText::ElideRight);
+    QFont f = m_windowTitleLabel->font();
+    f.setPointSize(kDefaultTitleBarFontPointSize);
+    m_windowTitleLabel->setFont(f);
 
-    setWindowIconSize(kDefaultWindowIconSize);
-    setWindowIconVisible(false);
 #ifdef Q_OS_MACOS
     setTitleLabelAlignment(Qt::AlignCenter);
 #else // !Q_OS_MACOS
@@ -574,11 +674,24 @@ void QuickStandardTitleBar::itemChange(const ItemChange change, const ItemChange
             updateChromeButtonColor();
         });
         m_windowTitleChangeConnection = connect(value.window, &QQuickWindow::windowTitleChanged, this, &QuickStandardTitleBar::updateTitleLabelText);
+        // The system buttons are only created once the title bar can actually be
+        // seen, title bars that stay hidden won't pay for them.
+#if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+        if (m_systemButtonsRow) {
+            // The buttons were created before we had a window, register them now.
+            registerSystemButtons();
+        } else
+#endif
+        if (isVisible()) {
+            ensureSystemButtons();
+        }
         updateAll();
         value.window->installEventFilter(this);
         // The window has changed, we need to re-add or re-remove the window icon rect to
         // the hit test visible whitelist. This is different with Qt Widgets.
         FramelessQuickHelper::get(this)->setHitTestVisible_rect(windowIconRect(), windowIconVisible_real());
+    } else if ((change == ItemVisibleHasChanged) && value.boolValue && window()) {
+        ensureSystemButtons();
     }
 }
 
@@ -28,8 +28,10 @@
 #if FRAMELESSHELPER_CONFIG(border_painter)
 
 #include <FramelessHelper/Core/windowborderpainter.h>
+#include <FramelessHelper/Core/private/windowborderpainter_p.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgrectanglenode.h>
 #if FRAMELESSHELPER_CONFIG(private_qt)
 #  include <QtQuick/private/qquickitem_p.h>
 #endif
@@ -87,6 +89,8 @@ using namespace Global;
     return result;
 }
 
+static constexpr const int kBorderNodeCount = 4;
+
 QuickWindowBorderPrivate::QuickWindowBorderPrivate(QuickWindowBorder *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -124,18 +128,22 @@ void QuickWindowBorderPrivate::update()
     if (!window) {
         return;
     }
-    q->update();
+    q->polish();
     q->setVisible(window->visibility() == QQuickWindow::Windowed);
 }
 
 void QuickWindowBorderPrivate::initialize()
 {
     Q_Q(QuickWindowBorder);
+    q->setFlag(QQuickItem::ItemHasContents);
     q->setClip(true);
     q->setSmooth(true);
     // We can't enable antialising for this element due to we are drawing
     // some very thin lines that are too fragile.
     q->setAntialiasing(false);
+    // Unlike QQuickPaintedItem, a plain item doesn't refresh its node on resize.
+    connect(q, &QuickWindowBorder::widthChanged, q, &QuickWindowBorder::update);
+    connect(q, &QuickWindowBorder::heightChanged, q, &QuickWindowBorder::update);
 
     borderPainter = new WindowBorderPainter(this);
     connect(borderPainter, &WindowBorderPainter::thicknessChanged,
@@ -148,7 +156,7 @@ void QuickWindowBorderPrivate::initialize()
         q, &QuickWindowBorder::inactiveColorChanged);
     connect(borderPainter, &WindowBorderPainter::nativeBorderChanged,
         q, &QuickWindowBorder::nativeBorderChanged);
-    connect(borderPainter, &WindowBorderPainter::shouldRepaint, q, [q](){ q->update(); });
+    connect(borderPainter, &WindowBorderPainter::shouldRepaint, q, &QuickWindowBorder::polish);
 }
 
 void QuickWindowBorderPrivate::rebindWindow()
@@ -177,28 +185,81 @@ void QuickWindowBorderPrivate::rebindWindow()
         this, &QuickWindowBorderPrivate::update);
     visibilityChangeConnection = connect(window, &QQuickWindow::visibilityChanged,
         this, &QuickWindowBorderPrivate::update);
+    q->polish();
 }
 
 QuickWindowBorder::QuickWindowBorder(QQuickItem *parent)
-    : QQuickPaintedItem(parent), d_ptr(std::make_unique<QuickWindowBorderPrivate>(this))
+    : QQuickItem(parent), d_ptr(std::make_unique<QuickWindowBorderPrivate>(this))
 {
 }
 
 QuickWindowBorder::~QuickWindowBorder() = default;
 
-void QuickWindowBorder::paint(QPainter *painter)
+QSGNode *QuickWindowBorder::updatePaintNode(QSGNode *old, UpdatePaintNodeData *data)
 {
-    Q_ASSERT(painter);
-    if (!painter) {
-        return;
+    Q_UNUSED(data);
+    Q_D(QuickWindowBorder);
+    QQuickWindow * const win = window();
+    const auto w = int(std::round(width()));
+    const auto h = int(std::round(height()));
+    if (!win || (w <= 0) || (h <= 0)) {
+        delete old;
+        return nullptr;
+    }
+    // The root node owns exactly one rectangle node per edge, in the order of
+    // top, bottom, left and right. Edges that are not drawn get an empty rect
+    // so that the node tree never needs to be rebuilt, and repaints caused by
+    // activation or theme changes only touch the node materials.
+    QSGNode *node = old;
+    if (!node) {
+        node = new QSGNode;
+        for (int i = 0; i != kBorderNodeCount; ++i) {
+            QSGRectangleNode * const edgeNode = win->createRectangleNode();
+            edgeNode->setRect(QRectF());
+            node->appendChildNode(edgeNode);
+        }
+    }
+    // Runs on the render thread, only consume what updatePolish() prepared.
+    const WindowBorderPainterPrivate::PaintCache &cache = d->paintCache;
+    // Same layout as WindowBorderPainter::paint(): the vertical strips don't
+    // overlap the horizontal ones so translucent colors stay uniform at the corners.
+    const int thickness = std::min(cache.thickness, std::min(w, h));
+    const int top = ((cache.edges & WindowEdge::Top) ? thickness : 0);
+    const int bottom = ((cache.edges & WindowEdge::Bottom) ? thickness : 0);
+    const int sideHeight = std::max(h - top - bottom, 0);
+    const int left = (((cache.edges & WindowEdge::Left) && (sideHeight > 0)) ? thickness : 0);
+    const int right = (((cache.edges & WindowEdge::Right) && (sideHeight > 0)) ? thickness : 0);
+    const QRectF rects[kBorderNodeCount] = {
+        QRectF(0, 0, (top > 0) ? w : 0, top),
+        QRectF(0, h - bottom, (bottom > 0) ? w : 0, bottom),
+        QRectF(0, top, left, (left > 0) ? sideHeight : 0),
+        QRectF(w - right, top, right, (right > 0) ? sideHeight : 0)
+    };
+    QSGNode *child = node->firstChild();
+    for (auto &&rect : rects) {
+        Q_ASSERT(child);
+        if (!child) {
+            break;
+        }
+        const auto edgeNode = static_cast<QSGRectangleNode *>(child);
+        if (edgeNode->rect() != rect) {
+            edgeNode->setRect(rect);
+        }
+        if (edgeNode->color() != cache.color) {
+            edgeNode->setColor(cache.color);
+        }
+        child = child->nextSibling();
     }
+    return node;
+}
+
+void QuickWindowBorder::updatePolish()
+{
+    QQuickItem::updatePolish();
     Q_D(QuickWindowBorder);
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
-    const QSize s = size().toSize();
-#else
-    const QSize s = QSizeF{ width(), height() }.toSize();
-#endif
-    d->borderPainter->paint(painter, s, (window() && window()->isActive()));
+    const QQuickWindow * const win = window();
+    d->paintCache = WindowBorderPainterPrivate::get(d->borderPainter)->getPaintCache(win && win->isActive());
+    update();
 }
 
 qreal QuickWindowBorder::thickness() const
@@ -287,7 +348,7 @@ void QuickWindowBorder::setInactiveColor(const QColor &value)
 
 void QuickWindowBorder::itemChange(const ItemChange change, const ItemChangeData &value)
 {
-    QQuickPaintedItem::itemChange(change, value);
+    QQuickItem::itemChange(change, value);
     if ((change == ItemSceneChange) && value.window) {
         Q_D(QuickWindowBorder);
         d->rebindWindow();
@@ -296,12 +357,12 @@ void QuickWindowBorder::itemChange(const ItemChange change, const ItemChangeData
 
 void QuickWindowBorder::classBegin()
 {
-    QQuickPaintedItem::classBegin();
+    QQuickItem::classBegin();
 }
 
 void QuickWindowBorder::componentComplete()
 {
-    QQuickPaintedItem::componentComplete();
+    QQuickItem::componentComplete();
 }
 
 FRAMELESSHELPER_END_NAMESPACE
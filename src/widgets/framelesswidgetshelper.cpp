@@ -38,6 +38,8 @@
 #include <FramelessHelper/Core/private/framelessmanager_p.h>
 #include <FramelessHelper/Core/private/framelessconfig_p.h>
 #include <FramelessHelper/Core/private/framelesshelpercore_global_p.h>
+#include <FramelessHelper/Core/private/windowreadinesswatcher_p.h>
+#include <FramelessHelper/Core/private/performancecounters_p.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qeventloop.h>
 #include <QtCore/qloggingcategory.h>
@@ -71,8 +73,6 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
-static constexpr const auto kRepaintTimerInterval = 300;
-
 struct FramelessWidgetsHelperExtraData : public FramelessExtraData
 {
     QPointer<QWidget> titleBarWidget = nullptr;
@@ -176,6 +176,7 @@ static inline void forceWidgetRepaint(QWidget *widget)
     if (!widget->isVisible()) {
         return;
     }
+    FRAMELESSHELPER_PERFORMANCE_COUNT(ForcedRepaints);
     // Tell the widget to repaint itself, but it may not happen due to QWidget's
     // internal painting optimizations.
     widget->update();
@@ -212,7 +213,6 @@ FramelessWidgetsHelperPrivate::FramelessWidgetsHelperPrivate(FramelessWidgetsHel
     }
     q_ptr = q;
     repaintTimer.setTimerType(Qt::VeryCoarseTimer);
-    repaintTimer.setInterval(kRepaintTimerInterval);
     connect(&repaintTimer, &QTimer::timeout, this, &FramelessWidgetsHelperPrivate::doRepaintAllChildren);
 }
 
@@ -372,11 +372,13 @@ FramelessWidgetsHelper *FramelessWidgetsHelperPrivate::findOrCreateFramelessHelp
 
 void FramelessWidgetsHelperPrivate::repaintAllChildren()
 {
-    repaintTimer.start();
+    // Read the delay every time, it can be changed at runtime.
+    repaintTimer.start(FramelessConfig::instance()->duration(ConfigValue::RepaintDelay));
 }
 
 void FramelessWidgetsHelperPrivate::doRepaintAllChildren()
 {
+    FRAMELESSHELPER_PERFORMANCE_TIME_SCOPE(RepaintAllChildren);
     repaintTimer.stop();
     if (!window) {
         return;
@@ -416,6 +418,13 @@ void FramelessWidgetsHelperPrivate::attach()
     if (!window->testAttribute(Qt::WA_DontCreateNativeAncestors)) {
         window->setAttribute(Qt::WA_DontCreateNativeAncestors);
     }
+    // QWidget::setWindowFlags() destroys and re-creates the native window if there
+    // already is one, so apply the frameless hint while there isn't one yet.
+    if (!window->testAttribute(Qt::WA_WState_Created) && FramelessManagerPrivate::shouldApplyFramelessWindowHint()
+        && !(window->windowFlags() & Qt::FramelessWindowHint)) {
+        window->setWindowFlags(window->windowFlags() | Qt::FramelessWindowHint);
+    }
+
     if (!window->testAttribute(Qt::WA_NativeWindow)) {
         window->setAttribute(Qt::WA_NativeWindow);
     }
@@ -433,7 +442,17 @@ void FramelessWidgetsHelperPrivate::attach()
         data->callbacks = FramelessCallbacks::create();
         data->callbacks->getWindowId = [this]() -> WId { return window->winId(); };
         data->callbacks->getWindowFlags = [this]() -> Qt::WindowFlags { return window->windowFlags(); };
-        data->callbacks->setWindowFlags = [this](const Qt::WindowFlags flags) -> void { window->setWindowFlags(flags); };
+        data->callbacks->setWindowFlags = [this](const Qt::WindowFlags flags) -> void {
+            // Update an existing platform window in place, QWidget::setWindowFlags()
+            // would destroy and re-create it (and make it flash on the screen).
+            QWindow * const handle = window->windowHandle();
+            if (handle && window->testAttribute(Qt::WA_WState_Created)) {
+                window->overrideWindowFlags(flags);
+                handle->setFlags(flags);
+            } else {
+                window->setWindowFlags(flags);
+            }
+        };
         data->callbacks->getWindowSize = [this]() -> QSize { return window->size(); };
         data->callbacks->setWindowSize = [this](const QSize &size) -> void { window->resize(size); };
         data->callbacks->getWindowPosition = [this]() -> QPoint { return window->pos(); };
@@ -487,24 +506,34 @@ void FramelessWidgetsHelperPrivate::attach()
 
     std::ignore = FramelessManager::instance()->addWindow(window, windowId);
 
-    // We have to wait for a little time before moving the top level window
-    // , because the platform window may not finish initializing by the time
-    // we reach here, and all the modifications from the Qt side will be lost
-    // due to QPA will reset the position and size of the window during it's
-    // initialization process.
-    QTimer::singleShot(qpaWaitTime, this, [this, q](){
-        qpaReady = true;
-        if (FramelessConfig::instance()->isSet(Option::CenterWindowBeforeShow)) {
-            q->moveWindowToDesktopCenter();
-        }
-        if (FramelessConfig::instance()->isSet(Option::EnableBlurBehindWindow)) {
-            q->setBlurBehindWindowEnabled(true);
+    // All the modifications from the Qt side will be lost if we apply them before the
+    // platform window finishes its initialization, because the QPA plugin will reset
+    // the position and size of the window during that process. So wait until it's
+    // really ready instead of guessing how long that may take.
+    WindowReadinessWatcher::watch(window->windowHandle(), this, [this](){
+        // An explicitly requested extra delay is still honored.
+        if (qpaWaitTime > 0) {
+            QTimer::singleShot(qpaWaitTime, this, [this](){ markReady(); });
+        } else {
+            markReady();
         }
-        emitSignalForAllInstances("windowChanged");
-        emitSignalForAllInstances("ready");
     });
 }
 
+void FramelessWidgetsHelperPrivate::markReady()
+{
+    Q_Q(FramelessWidgetsHelper);
+    qpaReady = true;
+    if (FramelessConfig::instance()->isSet(Option::CenterWindowBeforeShow)) {
+        q->moveWindowToDesktopCenter();
+    }
+    if (FramelessConfig::instance()->isSet(Option::EnableBlurBehindWindow)) {
+        q->setBlurBehindWindowEnabled(true);
+    }
+    emitSignalForAllInstances("windowChanged");
+    emitSignalForAllInstances("ready");
+}
+
 void FramelessWidgetsHelperPrivate::detach()
 {
     if (!window) {
@@ -544,6 +573,7 @@ QRect FramelessWidgetsHelperPrivate::mapWidgetGeometryToScene(const QWidget * co
 
 bool FramelessWidgetsHelperPrivate::isInSystemButtons(const QPoint &pos, SystemButtonType *button) const
 {
+    FRAMELESSHELPER_PERFORMANCE_COUNT(HitTests);
     Q_ASSERT(button);
     if (!button) {
         return false;
@@ -592,6 +622,8 @@ bool FramelessWidgetsHelperPrivate::isInSystemButtons(const QPoint &pos, SystemB
 
 bool FramelessWidgetsHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos) const
 {
+    FRAMELESSHELPER_PERFORMANCE_COUNT(HitTests);
+    FRAMELESSHELPER_PERFORMANCE_TIME_SCOPE(TitleBarHitTest);
     if (!window) {
         // The FramelessWidgetsHelper object has not been attached to a specific window yet,
         // so we assume there's no title bar.
@@ -902,6 +934,24 @@ bool FramelessWidgetsHelper::isReady() const
     return d->qpaReady;
 }
 
+void FramelessWidgetsHelper::callWhenReady(QObject *context, const std::function<void()> &callback)
+{
+    Q_ASSERT(callback);
+    if (!callback) {
+        return;
+    }
+    Q_D(FramelessWidgetsHelper);
+    if (d->qpaReady) {
+        callback();
+        return;
+    }
+    const auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(this, &FramelessWidgetsHelper::ready, (context ? context : this), [connection, callback](){
+        QObject::disconnect(*connection);
+        callback();
+    });
+}
+
 void FramelessWidgetsHelper::waitForReady()
 {
     Q_D(FramelessWidgetsHelper);
@@ -1021,6 +1071,19 @@ void FramelessWidgetsHelper::setHitTestVisible(QObject *object, const bool visib
     setHitTestVisible(widget, visible);
 }
 
+void FramelessWidgetsHelper::extendsContentIntoTitleBar(const QObjectList &objects, const bool value)
+{
+    if (objects.isEmpty()) {
+        return;
+    }
+    const FramelessRegistrationBatch batch(value ? int(objects.size()) : 0);
+    for (auto &&object : std::as_const(objects)) {
+        if (FramelessWidgetsHelper * const helper = get(object)) {
+            helper->extendsContentIntoTitleBar(value);
+        }
+    }
+}
+
 void FramelessWidgetsHelper::extendsContentIntoTitleBar(const bool value)
 {
     if (isContentExtendedIntoTitleBar() == value) {
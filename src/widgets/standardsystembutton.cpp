@@ -28,10 +28,13 @@
 #if FRAMELESSHELPER_CONFIG(system_button)
 
 #include <FramelessHelper/Core/utils.h>
+#include <FramelessHelper/Core/framelessmanager.h>
 #include <FramelessHelper/Core/private/framelessmanager_p.h>
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qset.h>
 #include <QtGui/qpainter.h>
 #include <QtGui/qevent.h>
+#include <QtGui/qpixmapcache.h>
 #include <QtWidgets/qtooltip.h>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
@@ -51,6 +54,69 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+FRAMELESSHELPER_STRING_CONSTANT2(GlyphCacheKeyPrefix, "org.wangwenx190.FramelessHelper.SystemButtonGlyph")
+
+struct GlyphCacheData
+{
+    // The keys we have put into QPixmapCache, so that we can drop them on theme changes.
+    QSet<QString> keys = {};
+    bool connected = false;
+};
+
+Q_GLOBAL_STATIC(GlyphCacheData, g_glyphCacheData)
+
+static inline void clearGlyphCache()
+{
+    for (auto &&key : std::as_const(g_glyphCacheData()->keys)) {
+        QPixmapCache::remove(key);
+    }
+    g_glyphCacheData()->keys.clear();
+}
+
+// Rasterizing an icon font glyph means font shaping and anti-aliased text rendering,
+// which is too expensive to do every time the user hovers over the buttons. The result
+// only depends on the parameters below, so share it across all buttons in the process.
+[[nodiscard]] static inline QPixmap getGlyphPixmap(const QString &glyph, const std::optional<int> &glyphSize,
+    const QSize &size, const QColor &color, const qreal devicePixelRatio)
+{
+    Q_ASSERT(!glyph.isEmpty());
+    Q_ASSERT(!size.isEmpty());
+    if (glyph.isEmpty() || size.isEmpty()) {
+        return {};
+    }
+    GlyphCacheData * const data = g_glyphCacheData();
+    if (!data->connected) {
+        data->connected = true;
+        FramelessManager * const manager = FramelessManager::instance();
+        QObject::connect(manager, &FramelessManager::systemThemeChanged, manager, clearGlyphCache);
+    }
+    const QString key = FRAMELESSHELPER_STRING_LITERAL("%1_%2_%3_%4x%5_%6_%7").arg(kGlyphCacheKeyPrefix, glyph)
+        .arg(glyphSize.value_or(0)).arg(size.width()).arg(size.height()).arg(color.rgba(), 0, 16).arg(devicePixelRatio);
+    QPixmap pixmap = {};
+    if (QPixmapCache::find(key, &pixmap)) {
+        return pixmap;
+    }
+    pixmap = QPixmap(QSizeF(QSizeF(size) * devicePixelRatio).toSize());
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(kDefaultTransparentColor);
+    QPainter painter(&pixmap);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
+    painter.setPen(color);
+    painter.setFont([&glyphSize]() -> QFont {
+        QFont font = FramelessManagerPrivate::getIconFont();
+        if (glyphSize.has_value()) {
+            font.setPointSize(glyphSize.value());
+        }
+        return font;
+    }());
+    painter.drawText(QRect(QPoint(0, 0), size), Qt::AlignCenter, glyph);
+    painter.end();
+    if (QPixmapCache::insert(key, pixmap)) {
+        data->keys.insert(key);
+    }
+    return pixmap;
+}
+
 StandardSystemButtonPrivate::StandardSystemButtonPrivate(StandardSystemButton *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -88,7 +154,6 @@ QSize StandardSystemButtonPrivate::getRecommendedButtonSize()
 StandardSystemButton::StandardSystemButton(QWidget *parent)
     : QPushButton(parent), d_ptr(std::make_unique<StandardSystemButtonPrivate>(this))
 {
-    FramelessManagerPrivate::initializeIconFont();
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
     setFixedSize(StandardSystemButtonPrivate::getRecommendedButtonSize());
     setIconSize(kDefaultSystemButtonIconSize);
@@ -302,9 +367,6 @@ void StandardSystemButton::paintEvent(QPaintEvent *event)
     }
     Q_D(StandardSystemButton);
     QPainter painter(this);
-    painter.save();
-    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing
-                           | QPainter::SmoothPixmapTransform);
     const bool isHovering = underMouse();
     const auto backgroundColor = [isHovering, d, this]() -> QColor {
         // The pressed state has higher priority than the hovered state.
@@ -324,7 +386,7 @@ void StandardSystemButton::paintEvent(QPaintEvent *event)
         painter.fillRect(buttonRect, backgroundColor);
     }
     if (!d->glyph.isEmpty()) {
-        painter.setPen([isHovering, d]() -> QColor {
+        const QColor foregroundColor = [isHovering, d]() -> QColor {
             if (!isHovering && !d->active && d->inactiveForegroundColor.isValid()) {
                 return d->inactiveForegroundColor;
             }
@@ -335,17 +397,10 @@ void StandardSystemButton::paintEvent(QPaintEvent *event)
                 return d->activeForegroundColor;
             }
             return kDefaultBlackColor;
-        }());
-        painter.setFont([d]() -> QFont {
-            QFont font = FramelessManagerPrivate::getIconFont();
-            if (d->glyphSize.has_value()) {
-                font.setPointSize(d->glyphSize.value());
-            }
-            return font;
-        }());
-        painter.drawText(buttonRect, Qt::AlignCenter, d->glyph);
+        }();
+        painter.drawPixmap(buttonRect.topLeft(), getGlyphPixmap(d->glyph, d->glyphSize,
+            buttonRect.size(), foregroundColor, devicePixelRatioF()));
     }
-    painter.restore();
     event->accept();
 }
 
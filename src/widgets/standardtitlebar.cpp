@@ -155,7 +155,7 @@ StandardTitleBarPrivate::FontMetrics StandardTitleBarPrivate::titleLabelSize() c
 int StandardTitleBarPrivate::titleLabelMaxWidth() const
 {
 #if (FRAMELESSHELPER_CONFIG(system_button) && !defined(Q_OS_MACOS))
-    const int chromeButtonAreaWidth = (closeButton->x() + closeButton->width() - minimizeButton->x());
+    const int chromeButtonAreaWidth = (closeButton ? (closeButton->x() + closeButton->width() - minimizeButton->x()) : 0);
 #else
     static constexpr const int chromeButtonAreaWidth = 70;
 #endif
@@ -171,6 +171,90 @@ int StandardTitleBarPrivate::titleLabelMaxWidth() const
     return std::max(textMaxWidth, 0);
 }
 
+const StandardTitleBarPrivate::TitleLabelCache &StandardTitleBarPrivate::titleLabelCache()
+{
+    Q_Q(const StandardTitleBar);
+    const QFont font = titleFont.value_or(defaultFont());
+    const QSize titleBarSize = q->size();
+    if (cachedTitleLabel.has_value() && (cachedTitleLabel->titleBarSize == titleBarSize)
+        && (cachedTitleLabel->font == font)) {
+        return cachedTitleLabel.value();
+    }
+    TitleLabelCache cache = {};
+    cache.font = font;
+    cache.titleBarSize = titleBarSize;
+    const QString text = (window ? window->windowTitle() : QString());
+    if (!text.isEmpty()) {
+        const QFontMetrics fontMetrics(font);
+        const QString elidedText = fontMetrics.elidedText(text, Qt::ElideRight, titleLabelMaxWidth(), Qt::TextShowMnemonic);
+        // No need to draw the text if there's only the elide mark left (or even less).
+        if (elidedText.size() > 3) {
+            const FontMetrics labelSize = titleLabelSize();
+            const int titleBarWidth = titleBarSize.width();
+            int x = 0;
+            if (labelAlignment & Qt::AlignLeft) {
+                x = (windowIconRect().right() + kDefaultTitleBarContentsMargin);
+            } else if (labelAlignment & Qt::AlignRight) {
+                x = (titleBarWidth - kDefaultTitleBarContentsMargin - labelSize.width);
+#if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+                if (minimizeButton) {
+                    x -= (titleBarWidth - minimizeButton->x());
+                }
+#endif
+            } else if (labelAlignment & Qt::AlignHCenter) {
+                x = std::round(qreal(titleBarWidth - labelSize.width) / qreal(2));
+            } else {
+                WARNING << "The alignment for the title label is not set!";
+            }
+            // QStaticText is positioned by its top-left corner rather than its baseline.
+            const int baseline = std::round((qreal(titleBarSize.height() - labelSize.height) / qreal(2)) + qreal(labelSize.ascent));
+            cache.position = QPoint(x, baseline - labelSize.ascent);
+            cache.text.setTextFormat(Qt::PlainText);
+            cache.text.setText(elidedText);
+            cache.text.prepare(QTransform(), font);
+        }
+    }
+    cachedTitleLabel = cache;
+    return cachedTitleLabel.value();
+}
+
+const StandardTitleBarPrivate::WindowIconCache &StandardTitleBarPrivate::windowIconCache()
+{
+    Q_Q(const StandardTitleBar);
+    const QSize titleBarSize = q->size();
+    const qreal devicePixelRatio = q->devicePixelRatioF();
+    if (cachedWindowIcon.has_value() && (cachedWindowIcon->titleBarSize == titleBarSize)
+        && qFuzzyCompare(cachedWindowIcon->devicePixelRatio, devicePixelRatio)) {
+        return cachedWindowIcon.value();
+    }
+    WindowIconCache cache = {};
+    cache.titleBarSize = titleBarSize;
+    cache.devicePixelRatio = devicePixelRatio;
+    const QRect iconRect = windowIconRect();
+    if (iconRect.isValid()) {
+        const QIcon icon = window->windowIcon();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+        cache.pixmap = icon.pixmap(iconRect.size(), devicePixelRatio);
+#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+        cache.pixmap = icon.pixmap(window->windowHandle(), iconRect.size());
+#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+        // Keep the icon centered inside its rect, just like QIcon::paint() does.
+        const QSize pixmapSize = (QSizeF(cache.pixmap.size()) / cache.pixmap.devicePixelRatio()).toSize();
+        cache.position = QPoint(iconRect.x() + ((iconRect.width() - pixmapSize.width()) / 2),
+                                iconRect.y() + ((iconRect.height() - pixmapSize.height()) / 2));
+    }
+    cachedWindowIcon = cache;
+    return cachedWindowIcon.value();
+}
+
+void StandardTitleBarPrivate::invalidateCache()
+{
+    Q_Q(StandardTitleBar);
+    cachedTitleLabel = std::nullopt;
+    cachedWindowIcon = std::nullopt;
+    q->update();
+}
+
 bool StandardTitleBarPrivate::mouseEventHandler(QMouseEvent *event)
 {
 #ifdef Q_OS_MACOS
@@ -294,6 +378,9 @@ bool StandardTitleBarPrivate::isInTitleBarIconArea(const QPoint &pos) const
 void StandardTitleBarPrivate::updateMaximizeButton()
 {
 #if (FRAMELESSHELPER_CONFIG(system_button) && defined(Q_OS_LINUX))
+    if (!maximizeButton) {
+        return;
+    }
     const bool max = window->isMaximized();
     maximizeButton->setButtonType(max ? SystemButtonType::Restore : SystemButtonType::Maximize);
     maximizeButton->setToolTip(max ? tr("Restore") : tr("Maximize"));
@@ -309,6 +396,9 @@ void StandardTitleBarPrivate::updateTitleBarColor()
 void StandardTitleBarPrivate::updateChromeButtonColor()
 {
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+    if (!minimizeButton) {
+        return;
+    }
     const bool active = window->isActiveWindow();
     const QColor activeForeground = chromePalette->titleBarActiveForegroundColor();
     const QColor inactiveForeground = chromePalette->titleBarInactiveForegroundColor();
@@ -339,6 +429,9 @@ void StandardTitleBarPrivate::updateChromeButtonColor()
 void StandardTitleBarPrivate::retranslateUi()
 {
 #if (FRAMELESSHELPER_CONFIG(system_button) && defined(Q_OS_LINUX))
+    if (!minimizeButton) {
+        return;
+    }
     minimizeButton->setToolTip(tr("Minimize"));
     maximizeButton->setToolTip(window->isMaximized() ? tr("Restore") : tr("Maximize"));
     closeButton->setToolTip(tr("Close"));
@@ -355,6 +448,12 @@ bool StandardTitleBarPrivate::eventFilter(QObject *object, QEvent *event)
     if (!object->isWidgetType()) {
         return QObject::eventFilter(object, event);
     }
+    Q_Q(StandardTitleBar);
+    if ((object == q) && (event->type() == QEvent::Polish)) {
+        // The title bar is about to be shown for the first time.
+        ensureSystemButtons();
+        return QObject::eventFilter(object, event);
+    }
     const auto widget = qobject_cast<QWidget *>(object);
     if (!widget->isWindow() || (widget != window)) {
         return QObject::eventFilter(object, event);
@@ -376,32 +475,17 @@ bool StandardTitleBarPrivate::eventFilter(QObject *object, QEvent *event)
     return QObject::eventFilter(object, event);
 }
 
-void StandardTitleBarPrivate::initialize()
+void StandardTitleBarPrivate::ensureSystemButtons()
 {
+#if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+    if (minimizeButton) {
+        return;
+    }
     Q_Q(StandardTitleBar);
-    window = q->window();
-    chromePalette = new ChromePalette(this);
-    connect(chromePalette, &ChromePalette::titleBarColorChanged,
-        this, &StandardTitleBarPrivate::updateTitleBarColor);
-    connect(chromePalette, &ChromePalette::chromeButtonColorChanged,
-        this, &StandardTitleBarPrivate::updateChromeButtonColor);
-    connect(window, &QWidget::windowIconChanged, this, [q](const QIcon &icon){
-        Q_UNUSED(icon);
-        q->update();
-    });
-    connect(window, &QWidget::windowTitleChanged, this, [q](const QString &title){
-        Q_UNUSED(title);
-        q->update();
-    });
-#ifdef Q_OS_MACOS
-    const auto titleBarLayout = new QHBoxLayout(q);
-    titleBarLayout->setSpacing(0);
-    titleBarLayout->setContentsMargins(0, 0, 0, 0);
-#elif FRAMELESSHELPER_CONFIG(system_button)
+    q->removeEventFilter(this);
     minimizeButton = new StandardSystemButton(SystemButtonType::Minimize, q);
     connect(minimizeButton, &StandardSystemButton::clicked, window, &QWidget::showMinimized);
     maximizeButton = new StandardSystemButton(SystemButtonType::Maximize, q);
-    updateMaximizeButton();
     connect(maximizeButton, &StandardSystemButton::clicked, this, [this](){
         if (window->isMaximized()) {
             window->showNormal();
@@ -436,11 +520,63 @@ void StandardTitleBarPrivate::initialize()
     systemButtonsOuterLayout->setContentsMargins(0, 0, 0, 0);
     systemButtonsOuterLayout->addLayout(systemButtonsInnerLayout);
     systemButtonsOuterLayout->addStretch();
+    const auto titleBarLayout = static_cast<QHBoxLayout *>(q->layout());
+    titleBarLayout->addLayout(systemButtonsOuterLayout);
+    updateMaximizeButton();
+    retranslateUi();
+    updateChromeButtonColor();
+    // The title label is laid out relative to the system buttons.
+    invalidateCache();
+    registerSystemButtons();
+#endif
+}
+
+void StandardTitleBarPrivate::registerSystemButtons()
+{
+#if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+    if (!minimizeButton) {
+        return;
+    }
+    // Only talk to a helper that already exists, FramelessWidgetsHelper::get() would
+    // create one and make the window frameless behind the user's back.
+    FramelessWidgetsHelper * const helper = window->findChild<FramelessWidgetsHelper *>();
+    if (!helper) {
+        return;
+    }
+    helper->setSystemButton(minimizeButton, SystemButtonType::Minimize);
+    helper->setSystemButton(maximizeButton, SystemButtonType::Maximize);
+    helper->setSystemButton(closeButton, SystemButtonType::Close);
+#endif
+}
+
+void StandardTitleBarPrivate::initialize()
+{
+    Q_Q(StandardTitleBar);
+    window = q->window();
+    chromePalette = new ChromePalette(this);
+    connect(chromePalette, &ChromePalette::titleBarColorChanged,
+        this, &StandardTitleBarPrivate::updateTitleBarColor);
+    connect(chromePalette, &ChromePalette::chromeButtonColorChanged,
+        this, &StandardTitleBarPrivate::updateChromeButtonColor);
+    connect(window, &QWidget::windowIconChanged, this, [this](const QIcon &icon){
+        Q_UNUSED(icon);
+        invalidateCache();
+    });
+    connect(window, &QWidget::windowTitleChanged, this, [this](const QString &title){
+        Q_UNUSED(title);
+        invalidateCache();
+    });
+    // The layout itself is always there, users may want to add their own widgets to it
+    // before the title bar is shown.
     const auto titleBarLayout = new QHBoxLayout(q);
     titleBarLayout->setSpacing(0);
     titleBarLayout->setContentsMargins(0, 0, 0, 0);
+#if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
     titleBarLayout->addStretch();
-    titleBarLayout->addLayout(systemButtonsOuterLayout);
+    // The system buttons are created the first time the title bar gets shown, or
+    // when the user asks for one of them. Title bars that are never shown (or are
+    // replaced by custom controls) won't pay for them.
+    q->installEventFilter(this);
 #endif
     retranslateUi();
     updateTitleBarColor();
@@ -466,18 +602,21 @@ StandardTitleBar::~StandardTitleBar() = default;
 StandardSystemButton *StandardTitleBar::minimizeButton() const
 {
     Q_D(const StandardTitleBar);
+    const_cast<StandardTitleBarPrivate *>(d)->ensureSystemButtons();
     return d->minimizeButton;
 }
 
 StandardSystemButton *StandardTitleBar::maximizeButton() const
 {
     Q_D(const StandardTitleBar);
+    const_cast<StandardTitleBarPrivate *>(d)->ensureSystemButtons();
     return d->maximizeButton;
 }
 
 StandardSystemButton *StandardTitleBar::closeButton() const
 {
     Q_D(const StandardTitleBar);
+    const_cast<StandardTitleBarPrivate *>(d)->ensureSystemButtons();
     return d->closeButton;
 }
 #endif
@@ -509,7 +648,7 @@ void StandardTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
         return;
     }
     d->labelAlignment = value;
-    update();
+    d->invalidateCache();
     Q_EMIT titleLabelAlignmentChanged();
 }
 
@@ -575,41 +714,17 @@ void StandardTitleBar::paintEvent(QPaintEvent *event)
         QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
     painter.fillRect(QRect(QPoint(0, 0), size()), backgroundColor);
     if (d->titleLabelVisible) {
-        const QString text = d->window->windowTitle();
-        if (!text.isEmpty()) {
+        const StandardTitleBarPrivate::TitleLabelCache &label = d->titleLabelCache();
+        if (!label.text.text().isEmpty()) {
             painter.setPen(foregroundColor);
-            painter.setFont(d->titleFont.value_or(d->defaultFont()));
-            const auto pos = [this, d]() -> QPoint {
-                const StandardTitleBarPrivate::FontMetrics labelSize = d->titleLabelSize();
-                const int titleBarWidth = width();
-                int x = 0;
-                if (d->labelAlignment & Qt::AlignLeft) {
-                    x = (d->windowIconRect().right() + kDefaultTitleBarContentsMargin);
-                } else if (d->labelAlignment & Qt::AlignRight) {
-                    x = (titleBarWidth - kDefaultTitleBarContentsMargin - labelSize.width);
-#if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
-                    x -= (titleBarWidth - d->minimizeButton->x());
-#endif
-                } else if (d->labelAlignment & Qt::AlignHCenter) {
-                    x = std::round(qreal(titleBarWidth - labelSize.width) / qreal(2));
-                } else {
-                    WARNING << "The alignment for the title label is not set!";
-                }
-                const int y = std::round((qreal(height() - labelSize.height) / qreal(2)) + qreal(labelSize.ascent));
-                return {x, y};
-            }();
-            const int textMaxWidth = d->titleLabelMaxWidth();
-            const QString elidedText = painter.fontMetrics().elidedText(text, Qt::ElideRight, textMaxWidth, Qt::TextShowMnemonic);
-            // No need to draw the text if there's only the elide mark left (or even less).
-            if (elidedText.size() > 3) {
-                painter.drawText(pos, elidedText);
-            }
+            painter.setFont(label.font);
+            painter.drawStaticText(label.position, label.text);
         }
     }
     if (d->windowIconVisible) {
-        const QIcon icon = d->window->windowIcon();
-        if (!icon.isNull()) {
-            icon.paint(&painter, d->windowIconRect());
+        const StandardTitleBarPrivate::WindowIconCache &icon = d->windowIconCache();
+        if (!icon.pixmap.isNull()) {
+            painter.drawPixmap(icon.position, icon.pixmap);
         }
     }
     painter.restore();
@@ -650,7 +765,7 @@ void StandardTitleBar::setWindowIconSize(const QSize &value)
     }
     Q_D(StandardTitleBar);
     d->windowIconSize = value;
-    update();
+    d->invalidateCache();
     Q_EMIT windowIconSizeChanged();
 }
 
@@ -667,7 +782,7 @@ void StandardTitleBar::setWindowIconVisible(const bool value)
         return;
     }
     d->windowIconVisible = value;
-    update();
+    d->invalidateCache();
     Q_EMIT windowIconVisibleChanged();
 #ifndef Q_OS_MACOS
     // Ideally we should use FramelessWidgetsHelper::get(this) everywhere, but sadly when
@@ -694,7 +809,7 @@ void StandardTitleBar::setTitleFont(const QFont &value)
     }
     Q_D(StandardTitleBar);
     d->titleFont = value;
-    update();
+    d->invalidateCache();
     Q_EMIT titleFontChanged();
 }
 
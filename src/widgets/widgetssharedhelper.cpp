@@ -32,12 +32,14 @@
 #endif
 #include <FramelessHelper/Core/utils.h>
 #include <FramelessHelper/Core/private/framelessconfig_p.h>
+#include <FramelessHelper/Core/private/performancecounters_p.h>
 #ifdef Q_OS_WINDOWS
 #  include <FramelessHelper/Core/private/winverhelper_p.h>
 #endif // Q_OS_WINDOWS
 #include <QtCore/qcoreevent.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qpainter.h>
+#include <QtGui/qevent.h>
 #include <QtGui/qwindow.h>
 #include <QtWidgets/qwidget.h>
 
@@ -81,11 +83,7 @@ void WidgetsSharedHelper::setup(QWidget *widget)
         m_borderRepaintConnection = {};
     }
     m_borderRepaintConnection = connect(m_borderPainter,
-        &WindowBorderPainter::shouldRepaint, this, [this](){
-            if (m_targetWidget) {
-                m_targetWidget->update();
-            }
-        });
+        &WindowBorderPainter::shouldRepaint, this, &WidgetsSharedHelper::invalidateBorder);
 #endif
 #if FRAMELESSHELPER_CONFIG(mica_material)
     m_micaMaterial = new MicaMaterial(this);
@@ -94,15 +92,14 @@ void WidgetsSharedHelper::setup(QWidget *widget)
         m_micaRedrawConnection = {};
     }
     m_micaRedrawConnection = connect(m_micaMaterial, &MicaMaterial::shouldRedraw,
-        this, [this](){
-            if (m_targetWidget) {
-                m_targetWidget->update();
-            }
-        });
+        this, &WidgetsSharedHelper::invalidateMica);
 #endif
     m_targetWidget->installEventFilter(this);
     updateContentsMargins();
     m_targetWidget->update();
+#if FRAMELESSHELPER_CONFIG(border_painter)
+    m_borderRegion = borderRegion();
+#endif
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
     QScreen *screen = m_targetWidget->screen();
 #else
@@ -130,7 +127,7 @@ void WidgetsSharedHelper::setMicaEnabled(const bool value)
     }
     m_micaEnabled = value;
     if (m_targetWidget) {
-        m_targetWidget->update();
+        invalidate(micaRegion());
     }
     Q_EMIT micaEnabledChanged();
 }
@@ -170,28 +167,56 @@ bool WidgetsSharedHelper::eventFilter(QObject *object, QEvent *event)
     //case QEvent::WindowDeactivate:
     case QEvent::ActivationChange:
     //case QEvent::ApplicationStateChange:
-        m_targetWidget->update();
+        // Only the window border and the Mica material depend on the activation state,
+        // the widget's own contents will be repainted by itself if it really needs to.
+#if FRAMELESSHELPER_CONFIG(mica_material)
+        if (m_micaEnabled) {
+            invalidateMica();
+        }
+#endif
+#if FRAMELESSHELPER_CONFIG(border_painter)
+        invalidateBorder();
+#endif
         break;
     case QEvent::Paint: {
+        FRAMELESSHELPER_PERFORMANCE_COUNT(WindowPaints);
+        const QRegion dirtyRegion = static_cast<QPaintEvent *>(event)->region();
+#if FRAMELESSHELPER_CONFIG(performance_counters)
+        for (auto &&rect : dirtyRegion) {
+            FRAMELESSHELPER_PERFORMANCE_ADD(PaintedPixels, quint64(rect.width()) * quint64(rect.height()));
+        }
+#endif
 #if FRAMELESSHELPER_CONFIG(mica_material)
         repaintMica();
 #endif
 #if FRAMELESSHELPER_CONFIG(border_painter)
-        repaintBorder();
+        repaintBorder(dirtyRegion);
 #endif
     } break;
     case QEvent::WindowStateChange:
         if (event->type() == QEvent::WindowStateChange) {
             updateContentsMargins();
             emitCustomWindowStateSignals();
+#if FRAMELESSHELPER_CONFIG(border_painter)
+            invalidateBorder();
+#endif
         }
         break;
     case QEvent::Move:
+#if FRAMELESSHELPER_CONFIG(mica_material)
+        if (m_micaEnabled) {
+            invalidateMica();
+        }
+#endif
+        break;
     case QEvent::Resize:
 #if FRAMELESSHELPER_CONFIG(mica_material)
         if (m_micaEnabled) {
-            m_targetWidget->update();
+            invalidateMica();
         }
+#endif
+#if FRAMELESSHELPER_CONFIG(border_painter)
+        invalidateBorder();
 #endif
         break;
     default:
@@ -200,7 +225,46 @@ bool WidgetsSharedHelper::eventFilter(QObject *object, QEvent *event)
     return QObject::eventFilter(object, event);
 }
 
+void WidgetsSharedHelper::invalidate(const QRegion &region)
+{
+    if (!m_targetWidget || region.isEmpty()) {
+        return;
+    }
+    m_targetWidget->update(region);
+}
+
 #if FRAMELESSHELPER_CONFIG(mica_material)
+QRegion WidgetsSharedHelper::micaRegion() const
+{
+    QRegion region = m_targetWidget->rect();
+    // Child widgets which fill their whole area by themselves will hide the
+    // material anyway, there's no need to repaint them just for the Mica.
+    const QObjectList children = m_targetWidget->children();
+    for (auto &&child : std::as_const(children)) {
+        if (!child->isWidgetType()) {
+            continue;
+        }
+        const auto widget = static_cast<const QWidget *>(child);
+        if (widget->isWindow() || !widget->isVisible()) {
+            continue;
+        }
+        const bool opaque = (widget->testAttribute(Qt::WA_OpaquePaintEvent)
+            || (widget->autoFillBackground() && (widget->palette().color(widget->backgroundRole()).alpha() == 255)));
+        if (opaque) {
+            region -= widget->geometry();
+        }
+    }
+    return region;
+}
+
+void WidgetsSharedHelper::invalidateMica()
+{
+    if (!m_targetWidget) {
+        return;
+    }
+    invalidate(micaRegion());
+}
+
 void WidgetsSharedHelper::repaintMica()
 {
     if (!m_micaEnabled) {
@@ -213,9 +277,54 @@ void WidgetsSharedHelper::repaintMica()
 #endif
 
 #if FRAMELESSHELPER_CONFIG(border_painter)
-void WidgetsSharedHelper::repaintBorder()
+QRegion WidgetsSharedHelper::borderRegion() const
 {
     if (Utils::windowStatesToWindowState(m_targetWidget->windowState()) != Qt::WindowNoState) {
+        return {};
+    }
+    const WindowEdges edges = m_borderPainter->edges();
+    if (!edges) {
+        return {};
+    }
+    // The border lines are antialiased and centered on the half pixel, so give them
+    // one more pixel, and a zero width pen still draws a one pixel wide line.
+    const int strip = (std::max(m_borderPainter->thickness(), 1) + 1);
+    const int width = m_targetWidget->width();
+    const int height = m_targetWidget->height();
+    QRegion region = {};
+    if (edges & WindowEdge::Left) {
+        region += QRect(0, 0, strip, height);
+    }
+    if (edges & WindowEdge::Top) {
+        region += QRect(0, 0, width, strip);
+    }
+    if (edges & WindowEdge::Right) {
+        region += QRect(width - strip, 0, strip, height);
+    }
+    if (edges & WindowEdge::Bottom) {
+        region += QRect(0, height - strip, width, strip);
+    }
+    return region;
+}
+
+void WidgetsSharedHelper::invalidateBorder()
+{
+    if (!m_targetWidget) {
+        return;
+    }
+    // Also repaint the area occupied by the previous border, in case the
+    // thickness, the edges or the widget size has changed in the mean time.
+    const QRegion region = borderRegion();
+    invalidate(region + m_borderRegion);
+    m_borderRegion = region;
+}
+
+void WidgetsSharedHelper::repaintBorder(const QRegion &dirtyRegion)
+{
+    if (Utils::windowStatesToWindowState(m_targetWidget->windowState()) != Qt::WindowNoState) {
+        return;
+    }
+    if (!dirtyRegion.intersects(borderRegion())) {
         return;
     }
     QPainter painter(m_targetWidget);